@@ -0,0 +1,122 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_BASE_RCU_PTR_H_
+#define CYBER_BASE_RCU_PTR_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "cyber/base/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+// Holds an immutable T that readers access without locks, allocation or
+// refcount traffic. Writers copy the current value, modify the copy and
+// publish it, then wait out a grace period before freeing the old one.
+// Updates are meant to be rare, and must not happen inside a read section
+// of the same RcuPtr on the same thread.
+template <typename T>
+class RcuPtr {
+ public:
+  class ReadGuard {
+   public:
+    explicit ReadGuard(const RcuPtr* rcu) : rcu_(rcu) {
+      parity_ = rcu_->epoch_.load() & 1;
+      rcu_->readers_[parity_].count.fetch_add(1);
+      value_ = rcu_->value_.load();
+    }
+    ReadGuard(ReadGuard&& other)
+        : rcu_(other.rcu_), value_(other.value_), parity_(other.parity_) {
+      other.rcu_ = nullptr;
+    }
+    ~ReadGuard() {
+      if (rcu_ != nullptr) {
+        rcu_->readers_[parity_].count.fetch_sub(1, std::memory_order_release);
+      }
+    }
+
+    const T& operator*() const { return *value_; }
+    const T* operator->() const { return value_; }
+
+   private:
+    ReadGuard(const ReadGuard&) = delete;
+    ReadGuard& operator=(const ReadGuard&) = delete;
+
+    const RcuPtr* rcu_;
+    const T* value_;
+    uint64_t parity_;
+  };
+
+  RcuPtr() : value_(new T()) {}
+  ~RcuPtr() { delete value_.load(); }
+
+  ReadGuard Read() const { return ReadGuard(this); }
+
+  template <typename Updater>
+  void Update(Updater&& updater);
+
+ private:
+  RcuPtr(const RcuPtr&) = delete;
+  RcuPtr& operator=(const RcuPtr&) = delete;
+
+  void WaitReaders(uint64_t parity);
+
+  struct alignas(CACHELINE_SIZE) Readers {
+    std::atomic<uint64_t> count = {0};
+  };
+
+  std::atomic<T*> value_;
+  std::atomic<uint64_t> epoch_ = {0};
+  mutable Readers readers_[2];
+  std::mutex update_mutex_;
+};
+
+template <typename T>
+template <typename Updater>
+void RcuPtr<T>::Update(Updater&& updater) {
+  std::lock_guard<std::mutex> lock(update_mutex_);
+  T* old_value = value_.load();
+  std::unique_ptr<T> new_value(new T(*old_value));
+  updater(new_value.get());
+  value_.store(new_value.release());
+
+  // Two flips: a reader may have sampled the epoch before the previous
+  // update and still be counted on the other parity.
+  for (int i = 0; i < 2; ++i) {
+    uint64_t epoch = epoch_.fetch_add(1);
+    WaitReaders(epoch & 1);
+  }
+  delete old_value;
+}
+
+template <typename T>
+void RcuPtr<T>::WaitReaders(uint64_t parity) {
+  while (readers_[parity].count.load(std::memory_order_acquire) != 0) {
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_BASE_RCU_PTR_H_
@@ -0,0 +1,73 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/base/rcu_ptr.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+TEST(RcuPtrTest, update) {
+  RcuPtr<std::vector<int>> rcu;
+  EXPECT_TRUE(rcu.Read()->empty());
+
+  rcu.Update([](std::vector<int>* value) { value->push_back(1); });
+  {
+    auto value = rcu.Read();
+    ASSERT_EQ(1, value->size());
+    EXPECT_EQ(1, (*value)[0]);
+  }
+
+  rcu.Update([](std::vector<int>* value) { value->push_back(2); });
+  EXPECT_EQ(2, rcu.Read()->size());
+}
+
+TEST(RcuPtrTest, concurrent_read) {
+  RcuPtr<std::vector<int>> rcu;
+  std::atomic<bool> done(false);
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&rcu, &done]() {
+      while (!done.load()) {
+        auto value = rcu.Read();
+        // every published vector holds 0, 1, ..., size - 1
+        for (size_t j = 0; j < value->size(); ++j) {
+          EXPECT_EQ(j, (*value)[j]);
+        }
+      }
+    });
+  }
+
+  for (int i = 0; i < 1000; ++i) {
+    rcu.Update([i](std::vector<int>* value) { value->push_back(i); });
+  }
+  done.store(true);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(1000, rcu.Read()->size());
+}
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,123 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Resume cost and memory footprint of stackful croutines, which switch
+// context with ctx_swap, against stackless ones, which call their step on
+// the processor's stack. Every case resumes --routines routines round robin
+// until --resumes resumes are done, one JSON object per case on stdout.
+//
+//   resume_benchmark --routines=1000 --resumes=10000000
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "cyber/croutine/croutine.h"
+
+DEFINE_int32(routines, 1000, "routines per case");
+DEFINE_int64(resumes, 10000000, "resumes per case");
+DEFINE_int32(stack_size, 64 * 1024, "stack size of the stackful routines");
+
+namespace apollo {
+namespace cyber {
+namespace croutine {
+
+namespace {
+
+uint64_t count = 0;
+
+void Stackful() {
+  for (;;) {
+    ++count;
+    CRoutine::Yield(RoutineState::READY);
+  }
+}
+
+RoutineState Stackless() {
+  ++count;
+  return RoutineState::READY;
+}
+
+long MaxRssKb() {  // NOLINT
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+void Run(const std::string& name,
+         const std::vector<std::shared_ptr<CRoutine>>& routines,
+         long rss_before_kb) {  // NOLINT
+  // the first round faults in the stacks, it is not timed
+  for (auto& cr : routines) {
+    cr->Resume();
+  }
+  long rss_kb = MaxRssKb() - rss_before_kb;  // NOLINT
+
+  count = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int64_t i = 0; i < FLAGS_resumes; ++i) {
+    routines[i % routines.size()]->Resume();
+  }
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+  printf(
+      "{\"routine\": \"%s\", \"routines\": %zu, \"resumes\": %llu, "
+      "\"ns_per_resume\": %.1f, \"rss_kb_per_routine\": %.2f}\n",
+      name.c_str(), routines.size(), static_cast<unsigned long long>(count),
+      static_cast<double>(ns) / static_cast<double>(FLAGS_resumes),
+      static_cast<double>(rss_kb) / static_cast<double>(routines.size()));
+}
+
+}  // namespace
+
+void RunAll() {
+  // stackless first, RSS only ever grows
+  {
+    auto rss = MaxRssKb();
+    std::vector<std::shared_ptr<CRoutine>> routines;
+    for (int i = 0; i < FLAGS_routines; ++i) {
+      routines.emplace_back(CRoutine::CreateStackless(Stackless));
+    }
+    Run("stackless", routines, rss);
+  }
+  {
+    auto rss = MaxRssKb();
+    std::vector<std::shared_ptr<CRoutine>> routines;
+    for (int i = 0; i < FLAGS_routines; ++i) {
+      routines.emplace_back(
+          std::make_shared<CRoutine>(Stackful, FLAGS_stack_size));
+    }
+    Run("stackful", routines, rss);
+  }
+}
+
+}  // namespace croutine
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  apollo::cyber::croutine::RunAll();
+  return 0;
+}
@@ -18,10 +18,10 @@
 
 #include <utility>
 
-#include "cyber/base/concurrent_object_pool.h"
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 #include "cyber/croutine/detail/routine_context.h"
+#include "cyber/croutine/stack_watermark.h"
 #include "cyber/event/perf_event_cache.h"
 
 namespace apollo {
@@ -35,7 +35,8 @@ thread_local CRoutine *CRoutine::current_routine_ = nullptr;
 thread_local char *CRoutine::main_stack_ = nullptr;
 
 namespace {
-std::shared_ptr<base::CCObjectPool<RoutineContext>> context_pool = nullptr;
+std::shared_ptr<RoutineContextPool> context_pool = nullptr;
+size_t default_stack_size = STACK_SIZE;
 std::once_flag pool_init_flag;
 
 void CRoutineEntry(void *arg) {
@@ -45,30 +46,71 @@ void CRoutineEntry(void *arg) {
 }
 }  // namespace
 
-CRoutine::CRoutine(const std::function<void()> &func) : func_(func) {
+CRoutine::CRoutine(const std::function<void()> &func, size_t stack_size)
+    : func_(func) {
   std::call_once(pool_init_flag, [&]() {
     auto routine_num = 100;
     auto &global_conf = common::GlobalData::Instance()->Config();
-    if (global_conf.has_scheduler_conf() &&
-        global_conf.scheduler_conf().has_routine_num()) {
-      routine_num = global_conf.scheduler_conf().routine_num();
+    if (global_conf.has_scheduler_conf()) {
+      auto &sched_conf = global_conf.scheduler_conf();
+      if (sched_conf.has_routine_num()) {
+        routine_num = sched_conf.routine_num();
+      }
+      if (sched_conf.has_default_stack_size()) {
+        default_stack_size = sched_conf.default_stack_size();
+      }
     }
-    context_pool.reset(new base::CCObjectPool<RoutineContext>(routine_num));
+    context_pool = std::make_shared<RoutineContextPool>();
+    context_pool->Reserve(default_stack_size, routine_num);
   });
 
-  context_ = context_pool->GetObject();
-  if (context_ == nullptr) {
-    AWARN << "Maximum routine context number exceeded! Please check "
-             "[routine_num] in config file.";
-    context_.reset(new RoutineContext());
-  }
+  context_ = context_pool->GetContext(stack_size == 0 ? default_stack_size
+                                                      : stack_size);
 
+  if (StackWatermark::Instance()->enabled()) {
+    PaintStack(context_.get());
+  }
   MakeContext(CRoutineEntry, this, context_.get());
   state_ = RoutineState::READY;
   updated_.test_and_set(std::memory_order_release);
 }
 
-CRoutine::~CRoutine() { context_ = nullptr; }
+CRoutine::CRoutine(const StepFunc &step) : step_(step) {
+  state_ = RoutineState::READY;
+  updated_.test_and_set(std::memory_order_release);
+}
+
+std::shared_ptr<CRoutine> CRoutine::CreateStackless(const StepFunc &step) {
+  return std::shared_ptr<CRoutine>(new CRoutine(step));
+}
+
+CRoutine::~CRoutine() {
+  RecordStackUsage();
+  context_ = nullptr;
+}
+
+void CRoutine::RecordStackUsage() {
+  auto watermark = StackWatermark::Instance();
+  if (likely(!watermark->enabled()) || stackless()) {
+    return;
+  }
+  watermark->Update(id_, StackHighWaterMark(context_.get()),
+                    context_->stack_size);
+}
+
+RoutineStats CRoutine::stats() const {
+  RoutineStats stats;
+  stats.activations = activations_.load(std::memory_order_relaxed);
+  stats.total_run_ns = total_run_ns_.load(std::memory_order_relaxed);
+  stats.max_run_ns = max_run_ns_.load(std::memory_order_relaxed);
+  stats.wakeups = wakeups_.load(std::memory_order_relaxed);
+  stats.total_wake_latency_ns =
+      total_wake_latency_ns_.load(std::memory_order_relaxed);
+  stats.max_wake_latency_ns =
+      max_wake_latency_ns_.load(std::memory_order_relaxed);
+  stats.last_processor = last_processor_.load(std::memory_order_relaxed);
+  return stats;
+}
 
 RoutineState CRoutine::Resume() {
   if (unlikely(force_stop_)) {
@@ -83,10 +125,14 @@ RoutineState CRoutine::Resume() {
 
   current_routine_ = this;
   PerfEventCache::Instance()->AddSchedEvent(
-      SchedPerf::SWAP_IN, id_, processor_id_, static_cast<int>(state_));
-  SwapContext(GetMainStack(), GetStack());
+      SchedPerf::SWAP_IN, id_, processor_id(), static_cast<int>(state_));
+  if (stackless()) {
+    state_ = step_();
+  } else {
+    SwapContext(GetMainStack(), GetStack());
+  }
   PerfEventCache::Instance()->AddSchedEvent(
-      SchedPerf::SWAP_OUT, id_, processor_id_, static_cast<int>(state_));
+      SchedPerf::SWAP_OUT, id_, processor_id(), static_cast<int>(state_));
   current_routine_ = nullptr;
   return state_;
 }
@@ -19,17 +19,23 @@
 
 #include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <set>
 #include <string>
 
+#include "cyber/base/macros.h"
 #include "cyber/common/log.h"
 #include "cyber/croutine/detail/routine_context.h"
 
 namespace apollo {
 namespace cyber {
+namespace scheduler {
+struct ClassicGroup;
+}  // namespace scheduler
+
 namespace croutine {
 
 using RoutineFunc = std::function<void()>;
@@ -37,11 +43,35 @@ using Duration = std::chrono::microseconds;
 
 enum class RoutineState { READY, FINISHED, SLEEP, IO_WAIT, DATA_WAIT };
 
+// Runtime accounting of a routine, see CRoutine::BeginRun. Latencies are
+// from a notify to the Resume() serving it, wakeups counts the activations
+// that had one.
+struct RoutineStats {
+  uint64_t activations = 0;
+  uint64_t total_run_ns = 0;
+  uint64_t max_run_ns = 0;
+  uint64_t wakeups = 0;
+  uint64_t total_wake_latency_ns = 0;
+  uint64_t max_wake_latency_ns = 0;
+  // thread id of the processor it last ran on, -1 for none
+  int last_processor = -1;
+};
+
+// One activation of a stackless routine, returns the state to continue in.
+using StepFunc = std::function<RoutineState()>;
+
 class CRoutine {
  public:
-  explicit CRoutine(const RoutineFunc &func);
+  // |stack_size| of 0 takes [default_stack_size] from the scheduler conf
+  explicit CRoutine(const RoutineFunc &func, size_t stack_size = 0);
   virtual ~CRoutine();
 
+  // A routine without a context of its own: every Resume() calls |step| on
+  // the processor's stack and it has to return instead of yielding, so
+  // there is no stack to allocate and no context to swap. Yield(), Sleep()
+  // and HangUp() only record the state there, the step returns right after.
+  static std::shared_ptr<CRoutine> CreateStackless(const StepFunc &step);
+
   // static interfaces
   static void Yield();
   static void Yield(const RoutineState &state);
@@ -57,9 +87,20 @@ class CRoutine {
     return lock_.clear(std::memory_order_release);
   }
 
+  // Guards ready queue membership, the scheduler that sets it owns putting
+  // the routine back after it ran, and clears it once the routine waits.
+  bool MarkQueued() {
+    return !queued_.test_and_set(std::memory_order_acq_rel);
+  }
+
+  void ClearQueued() { queued_.clear(std::memory_order_release); }
+
   // It is caller's responsibility to check if state_ is valid before calling
   // SetUpdateFlag().
   void SetUpdateFlag() {
+    uint64_t none = 0;
+    notify_ns_.compare_exchange_strong(none, NowNs(),
+                                       std::memory_order_relaxed);
     updated_.clear(std::memory_order_release);
   }
 
@@ -68,7 +109,17 @@ class CRoutine {
   RoutineState Resume();
   RoutineState UpdateState();
 
+  // Accounting around Resume() by the processor holding the routine. The
+  // counters are written by that processor only, stats() may be read from
+  // anywhere.
+  void BeginRun(int processor);
+  void EndRun();
+  RoutineStats stats() const;
+
+  bool stackless() const { return context_ == nullptr; }
   RoutineContext *GetContext() { return context_.get(); }
+  // Hands the stack high water mark to StackWatermark, if it is enabled.
+  void RecordStackUsage();
   char **GetStack() { return &(context_->sp); }
 
   void Run() { func_(); }
@@ -89,33 +140,100 @@ class CRoutine {
   const std::string &name() const { return name_; }
   void set_name(const std::string &name) { name_ = name; }
 
-  int processor_id() const { return processor_id_; }
-  void set_processor_id(int processor_id) { processor_id_ = processor_id; }
+  int processor_id() const {
+    return processor_id_.load(std::memory_order_relaxed);
+  }
+  void set_processor_id(int processor_id) {
+    processor_id_.store(processor_id, std::memory_order_relaxed);
+  }
 
   uint32_t priority() const { return priority_; }
   void set_priority(uint32_t priority) { priority_ = priority; }
 
   std::chrono::steady_clock::time_point wake_time() const { return wake_time_; }
 
-  void set_group_name(const std::string &group_name) { group_name_ = group_name; }
+  void set_group_name(const std::string &group_name) {
+    group_name_ = group_name;
+    group_.store(nullptr, std::memory_order_release);
+  }
+
+  // State of its group the classic scheduler caches on first use, so that
+  // a notify does not look the group up by name. Reset with the name.
+  scheduler::ClassicGroup *group() const {
+    return group_.load(std::memory_order_acquire);
+  }
+  void set_group(scheduler::ClassicGroup *group) {
+    group_.store(group, std::memory_order_release);
+  }
+
+  // slot in its group of the processor that ran it last, -1 for none
+  int processor_slot() const {
+    return processor_slot_.load(std::memory_order_relaxed);
+  }
+  void set_processor_slot(int slot) {
+    processor_slot_.store(slot, std::memory_order_relaxed);
+  }
   const std::string &group_name() { return group_name_; }
 
+  // Set while the scheduler moves it to another group. Whoever holds it
+  // queued lets go of it instead of queuing it again, see
+  // ClassicContext::Migrate.
+  bool migrating() const { return migrating_.load(std::memory_order_acquire); }
+  void set_migrating(bool migrating) {
+    migrating_.store(migrating, std::memory_order_release);
+  }
+
  private:
+  explicit CRoutine(const StepFunc &step);
   CRoutine(CRoutine &) = delete;
   CRoutine &operator=(CRoutine &) = delete;
 
+  static uint64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  // the counters have a single writer, no read-modify-write needed
+  static void AddRelaxed(std::atomic<uint64_t> *counter, uint64_t value) {
+    counter->store(counter->load(std::memory_order_relaxed) + value,
+                   std::memory_order_relaxed);
+  }
+
+  static void MaxRelaxed(std::atomic<uint64_t> *counter, uint64_t value) {
+    if (value > counter->load(std::memory_order_relaxed)) {
+      counter->store(value, std::memory_order_relaxed);
+    }
+  }
+
   std::chrono::steady_clock::time_point wake_time_ =
       std::chrono::steady_clock::now();
 
   RoutineFunc func_;
+  StepFunc step_;
   RoutineState state_;
 
   std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
   std::atomic_flag updated_ = ATOMIC_FLAG_INIT;
+  std::atomic_flag queued_ = ATOMIC_FLAG_INIT;
+
+  // first notify not served yet, 0 for none
+  std::atomic<uint64_t> notify_ns_ = {0};
+  uint64_t run_start_ns_ = 0;
+  std::atomic<uint64_t> activations_ = {0};
+  std::atomic<uint64_t> total_run_ns_ = {0};
+  std::atomic<uint64_t> max_run_ns_ = {0};
+  std::atomic<uint64_t> wakeups_ = {0};
+  std::atomic<uint64_t> total_wake_latency_ns_ = {0};
+  std::atomic<uint64_t> max_wake_latency_ns_ = {0};
+  std::atomic<int> last_processor_ = {-1};
 
   bool force_stop_ = false;
 
-  int processor_id_ = -1;
+  std::atomic<int> processor_id_ = {-1};
+  std::atomic<int> processor_slot_ = {-1};
+  std::atomic<scheduler::ClassicGroup *> group_ = {nullptr};
+  std::atomic<bool> migrating_ = {false};
   uint32_t priority_ = 0;
   uint64_t id_ = 0;
 
@@ -130,11 +248,36 @@ class CRoutine {
 inline void CRoutine::Yield(const RoutineState &state) {
   auto routine = GetCurrentRoutine();
   routine->set_state(state);
+  if (unlikely(routine->stackless())) {
+    return;
+  }
   SwapContext(routine->GetStack(), GetMainStack());
 }
 
 inline void CRoutine::Yield() {
-  SwapContext(GetCurrentRoutine()->GetStack(), GetMainStack());
+  auto routine = GetCurrentRoutine();
+  if (unlikely(routine->stackless())) {
+    return;
+  }
+  SwapContext(routine->GetStack(), GetMainStack());
+}
+
+inline void CRoutine::BeginRun(int processor) {
+  run_start_ns_ = NowNs();
+  last_processor_.store(processor, std::memory_order_relaxed);
+  auto notified = notify_ns_.exchange(0, std::memory_order_relaxed);
+  if (notified != 0 && notified < run_start_ns_) {
+    AddRelaxed(&wakeups_, 1);
+    AddRelaxed(&total_wake_latency_ns_, run_start_ns_ - notified);
+    MaxRelaxed(&max_wake_latency_ns_, run_start_ns_ - notified);
+  }
+}
+
+inline void CRoutine::EndRun() {
+  auto run_ns = NowNs() - run_start_ns_;
+  AddRelaxed(&activations_, 1);
+  AddRelaxed(&total_run_ns_, run_ns);
+  MaxRelaxed(&max_run_ns_, run_ns);
 }
 
 inline RoutineState CRoutine::UpdateState() {
@@ -15,6 +15,10 @@
  *****************************************************************************/
 #include "cyber/croutine/croutine.h"
 
+#include <chrono>
+#include <thread>
+
+
 // #include "cyber/cyber.h"
 // #include "cyber/init.h"
 #include "cyber/common/global_data.h"
@@ -29,6 +33,12 @@ namespace croutine {
 using apollo::cyber::common::GlobalData;
 
 void function() { CRoutine::Yield(RoutineState::IO_WAIT); }
+void deep_function() {
+  volatile char buffer[32 * 1024];
+  buffer[0] = 1;
+  buffer[sizeof(buffer) - 1] = buffer[0];
+  CRoutine::Yield(RoutineState::IO_WAIT);
+}
 void Init(const char* program) { SetState(STATE_INITIALIZED); }
 
 TEST(Croutine, croutinetest) {
@@ -54,6 +64,93 @@ TEST(Croutine, croutinetest) {
   EXPECT_EQ(cr->Resume(), RoutineState::FINISHED);
 }
 
+TEST(Croutine, stack_size) {
+  Init("croutine_test");
+  auto cr = std::make_shared<CRoutine>(deep_function, 64 * 1024);
+  auto context = cr->GetContext();
+  EXPECT_EQ(64 * 1024, context->stack_size);
+  EXPECT_EQ(RoutineState::IO_WAIT, cr->Resume());
+
+  // below the minimum
+  auto small = std::make_shared<CRoutine>(function, 1024);
+  EXPECT_EQ(MIN_STACK_SIZE, small->GetContext()->stack_size);
+
+  // released contexts are reused
+  cr = nullptr;
+  cr = std::make_shared<CRoutine>(function, 64 * 1024);
+  EXPECT_EQ(context, cr->GetContext());
+
+  // an overflow hits the guard page
+  volatile char* below = cr->GetContext()->stack - 1;
+  EXPECT_DEATH(*below = 0, "");
+}
+
+TEST(Croutine, stackless) {
+  Init("croutine_test");
+  int steps = 0;
+  auto cr = CRoutine::CreateStackless([&steps]() {
+    EXPECT_TRUE(CRoutine::GetCurrentRoutine()->stackless());
+    if (++steps < 3) {
+      return RoutineState::READY;
+    }
+    // only records the state and returns
+    CRoutine::GetCurrentRoutine()->Sleep(Duration(1000000));
+    return RoutineState::SLEEP;
+  });
+  EXPECT_TRUE(cr->stackless());
+  EXPECT_EQ(nullptr, cr->GetContext());
+  EXPECT_EQ(RoutineState::READY, cr->Resume());
+  EXPECT_EQ(RoutineState::READY, cr->Resume());
+  EXPECT_EQ(RoutineState::SLEEP, cr->Resume());
+  EXPECT_EQ(3, steps);
+  EXPECT_EQ(RoutineState::SLEEP, cr->UpdateState());
+  EXPECT_EQ(nullptr, CRoutine::GetCurrentRoutine());
+
+  cr->set_state(RoutineState::DATA_WAIT);
+  cr->SetUpdateFlag();
+  EXPECT_EQ(RoutineState::READY, cr->UpdateState());
+  cr->Stop();
+  EXPECT_EQ(RoutineState::FINISHED, cr->Resume());
+  EXPECT_EQ(3, steps);
+}
+
+TEST(Croutine, stats) {
+  Init("croutine_test");
+  auto cr = CRoutine::CreateStackless([]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    return RoutineState::DATA_WAIT;
+  });
+  EXPECT_EQ(0, cr->stats().activations);
+  EXPECT_EQ(-1, cr->stats().last_processor);
+
+  // the first run was not notified
+  cr->BeginRun(7);
+  cr->Resume();
+  cr->EndRun();
+  auto stats = cr->stats();
+  EXPECT_EQ(1, stats.activations);
+  EXPECT_EQ(0, stats.wakeups);
+  EXPECT_GE(stats.max_run_ns, 2000000);
+  EXPECT_EQ(stats.max_run_ns, stats.total_run_ns);
+  EXPECT_EQ(7, stats.last_processor);
+
+  // latency counts from the first of several notifies
+  cr->SetUpdateFlag();
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  cr->SetUpdateFlag();
+  cr->UpdateState();
+  cr->BeginRun(8);
+  cr->Resume();
+  cr->EndRun();
+  stats = cr->stats();
+  EXPECT_EQ(2, stats.activations);
+  EXPECT_EQ(1, stats.wakeups);
+  EXPECT_GE(stats.max_wake_latency_ns, 1000000);
+  EXPECT_EQ(stats.max_wake_latency_ns, stats.total_wake_latency_ns);
+  EXPECT_GE(stats.total_run_ns, 4000000);
+  EXPECT_EQ(8, stats.last_processor);
+}
+
 }  // namespace croutine
 }  // namespace cyber
 }  // namespace apollo
@@ -16,10 +16,120 @@
 
 #include "cyber/croutine/detail/routine_context.h"
 
+#include <errno.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 namespace apollo {
 namespace cyber {
 namespace croutine {
 
+namespace {
+constexpr unsigned char STACK_PAINT = 0x5a;
+
+size_t PageSize() {
+  static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return page_size;
+}
+}  // namespace
+
+RoutineContext::RoutineContext(size_t size)
+    : stack_size(RoutineContextPool::RoundStackSize(size)) {
+  // MAP_NORESERVE: only the pages the routine actually touches get committed
+  mapping_size_ = stack_size + PageSize();
+  void* mapping = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (mapping == MAP_FAILED) {
+    AFATAL << "mmap routine stack of " << mapping_size_
+           << " bytes failed: " << std::strerror(errno);
+    return;
+  }
+  mapping_ = static_cast<char*>(mapping);
+  // stacks grow downwards, the guard page sits at the lowest address
+  if (mprotect(mapping_, PageSize(), PROT_NONE) != 0) {
+    AWARN << "mprotect routine stack guard page failed: "
+          << std::strerror(errno);
+  }
+  stack = mapping_ + PageSize();
+}
+
+RoutineContext::~RoutineContext() {
+  if (mapping_ != nullptr) {
+    munmap(mapping_, mapping_size_);
+  }
+}
+
+RoutineContextPool::~RoutineContextPool() {
+  for (auto& item : free_contexts_) {
+    for (auto context : item.second) {
+      delete context;
+    }
+  }
+}
+
+size_t RoutineContextPool::RoundStackSize(size_t stack_size) {
+  if (stack_size < MIN_STACK_SIZE) {
+    stack_size = MIN_STACK_SIZE;
+  }
+  size_t page_size = PageSize();
+  return (stack_size + page_size - 1) / page_size * page_size;
+}
+
+void RoutineContextPool::Reserve(size_t stack_size, size_t num) {
+  stack_size = RoundStackSize(stack_size);
+  std::lock_guard<std::mutex> lock(mutex_);
+  reserved_sizes_.insert(stack_size);
+  auto& contexts = free_contexts_[stack_size];
+  contexts.reserve(contexts.size() + num);
+  for (size_t i = 0; i < num; ++i) {
+    contexts.push_back(new RoutineContext(stack_size));
+  }
+}
+
+std::shared_ptr<RoutineContext> RoutineContextPool::GetContext(
+    size_t stack_size) {
+  stack_size = RoundStackSize(stack_size);
+  RoutineContext* context = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& contexts = free_contexts_[stack_size];
+    if (!contexts.empty()) {
+      context = contexts.back();
+      contexts.pop_back();
+    } else if (!grown_ && reserved_sizes_.count(stack_size) > 0) {
+      // sizes nobody reserved are mapped on demand without a warning
+      grown_ = true;
+      AWARN << "Routine context pool exhausted, growing it. Please check "
+               "[routine_num] in config file.";
+    }
+  }
+  if (context == nullptr) {
+    context = new RoutineContext(stack_size);
+  }
+  auto self = shared_from_this();
+  return std::shared_ptr<RoutineContext>(
+      context, [self](RoutineContext* context) { self->Release(context); });
+}
+
+void RoutineContextPool::Release(RoutineContext* context) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  free_contexts_[context->stack_size].push_back(context);
+}
+
+void PaintStack(RoutineContext* ctx) {
+  std::memset(ctx->stack, STACK_PAINT, ctx->stack_size);
+}
+
+size_t StackHighWaterMark(const RoutineContext* ctx) {
+  // the stack grows downwards, the lowest overwritten byte is the deepest
+  auto stack = reinterpret_cast<const volatile unsigned char*>(ctx->stack);
+  size_t offset = 0;
+  while (offset < ctx->stack_size && stack[offset] == STACK_PAINT) {
+    ++offset;
+  }
+  return ctx->stack_size - offset;
+}
+
 //  The stack layout looks as follows:
 //
 //              +------------------+
@@ -38,12 +148,12 @@ namespace croutine {
 // ctx->sp  =>  |        RBP       |
 //              +------------------+
 void MakeContext(const func &f1, const void *arg, RoutineContext *ctx) {
-  ctx->sp = ctx->stack + STACK_SIZE - 2 * sizeof(void *) - REGISTERS_SIZE;
+  ctx->sp = ctx->stack + ctx->stack_size - 2 * sizeof(void *) - REGISTERS_SIZE;
   std::memset(ctx->sp, 0, REGISTERS_SIZE);
 #ifdef __aarch64__
-  char *sp = ctx->stack + STACK_SIZE - sizeof(void *);
+  char *sp = ctx->stack + ctx->stack_size - sizeof(void *);
 #else
-  char *sp = ctx->stack + STACK_SIZE - 2 * sizeof(void *);
+  char *sp = ctx->stack + ctx->stack_size - 2 * sizeof(void *);
 #endif
   *reinterpret_cast<void **>(sp) = reinterpret_cast<void *>(f1);
   sp -= sizeof(void *);
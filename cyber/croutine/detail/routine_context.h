@@ -20,8 +20,14 @@
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "cyber/common/log.h"
+#include "cyber/common/macros.h"
 
 extern "C" {
 extern void ctx_swap(void**, void**) asm("ctx_swap");
@@ -32,6 +38,7 @@ namespace cyber {
 namespace croutine {
 
 constexpr size_t STACK_SIZE = 2 * 1024 * 1024;
+constexpr size_t MIN_STACK_SIZE = 16 * 1024;
 #if defined __aarch64__
 constexpr size_t REGISTERS_SIZE = 160;
 #else
@@ -39,17 +46,58 @@ constexpr size_t REGISTERS_SIZE = 56;
 #endif
 
 typedef void (*func)(void*);
+
+// The stack is an mmap'ed region the kernel commits page by page on first
+// touch, with a PROT_NONE guard page below it so an overflow faults instead
+// of corrupting the memory next to it.
 struct RoutineContext {
-  char stack[STACK_SIZE];
+  explicit RoutineContext(size_t size = STACK_SIZE);
+  ~RoutineContext();
+
+  char* stack = nullptr;
+  size_t stack_size = 0;
   char* sp = nullptr;
-#if defined __aarch64__
-} __attribute__((aligned(16)));
-#else
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(RoutineContext)
+
+  char* mapping_ = nullptr;
+  size_t mapping_size_ = 0;
+};
+
+// Recycles contexts per stack size. Running out of contexts grows the pool
+// rather than failing, every context goes back to it when released.
+class RoutineContextPool
+    : public std::enable_shared_from_this<RoutineContextPool> {
+ public:
+  RoutineContextPool() = default;
+  ~RoutineContextPool();
+
+  // |num| contexts of |stack_size| are mapped up front
+  void Reserve(size_t stack_size, size_t num);
+  std::shared_ptr<RoutineContext> GetContext(size_t stack_size);
+
+  static size_t RoundStackSize(size_t stack_size);
+
+ private:
+  void Release(RoutineContext* context);
+
+  std::mutex mutex_;
+  std::unordered_map<size_t, std::vector<RoutineContext*>> free_contexts_;
+  std::unordered_set<size_t> reserved_sizes_;
+  bool grown_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(RoutineContextPool)
 };
-#endif
 
 void MakeContext(const func& f1, const void* arg, RoutineContext* ctx);
 
+// Fills the stack with a pattern, StackHighWaterMark then tells how deep the
+// routine has grown it. Painting touches every page of the stack, so only
+// do it when the stack usage is wanted.
+void PaintStack(RoutineContext* ctx);
+size_t StackHighWaterMark(const RoutineContext* ctx);
+
 inline void SwapContext(char** src_sp, char** dest_sp) {
   ctx_swap(reinterpret_cast<void**>(src_sp), reinterpret_cast<void**>(dest_sp));
 }
@@ -18,7 +18,9 @@
 #define CYBER_CROUTINE_ROUTINE_FACTORY_H_
 
 #include <memory>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
@@ -34,8 +36,11 @@ class RoutineFactory {
  public:
   using VoidFunc = std::function<void()>;
   using CreateRoutineFunc = std::function<VoidFunc()>;
+  using CreateStepFunc = std::function<StepFunc()>;
   // We can use routine_func directly.
   CreateRoutineFunc create_routine;
+  // set instead of create_routine for a stackless routine
+  CreateStepFunc create_step;
   inline std::shared_ptr<data::DataVisitorBase> GetDataVisitor() const {
     return data_visitor_;
   }
@@ -69,43 +74,48 @@ RoutineFactory CreateRoutineFactory(
   return factory;
 }
 
-template <typename M0, typename M1, typename F>
-RoutineFactory CreateRoutineFactory(
-    F&& f, const std::shared_ptr<data::DataVisitor<M0, M1>>& dv) {
+// Same as CreateRoutineFactory, but the routine is stackless: each
+// activation handles at most one message and returns to the processor.
+template <typename M0, typename F>
+RoutineFactory CreateStacklessRoutineFactory(
+    F&& f, const std::shared_ptr<data::DataVisitor<M0>>& dv) {
   RoutineFactory factory;
   factory.SetDataVisitor(dv);
-  factory.create_routine = [=]() {
+  factory.create_step = [=]() {
     return [=]() {
-      std::shared_ptr<M0> msg0;
-      std::shared_ptr<M1> msg1;
-      for (;;) {
-        CRoutine::GetCurrentRoutine()->set_state(RoutineState::DATA_WAIT);
-        if (dv->TryFetch(msg0, msg1)) {
-          f(msg0, msg1);
-          CRoutine::Yield(RoutineState::READY);
-        } else {
-          CRoutine::Yield();
-        }
+      std::shared_ptr<M0> msg;
+      if (!dv->TryFetch(msg)) {
+        return RoutineState::DATA_WAIT;
       }
+      f(msg);
+      return RoutineState::READY;
     };
   };
   return factory;
 }
 
-template <typename M0, typename M1, typename M2, typename F>
-RoutineFactory CreateRoutineFactory(
-    F&& f, const std::shared_ptr<data::DataVisitor<M0, M1, M2>>& dv) {
+// Drains up to |max_batch_size| pending messages per activation and hands
+// them to |f| in one call, instead of one scheduler round trip per message.
+// A |max_batch_size| of 0 is taken as 1.
+template <typename M0, typename F>
+RoutineFactory CreateBatchRoutineFactory(
+    F&& f, const std::shared_ptr<data::DataVisitor<M0>>& dv,
+    uint64_t max_batch_size) {
+  if (max_batch_size == 0) {
+    AWARN << "max_batch_size 0 would never fetch a message, using 1.";
+    max_batch_size = 1;
+  }
   RoutineFactory factory;
   factory.SetDataVisitor(dv);
   factory.create_routine = [=]() {
     return [=]() {
-      std::shared_ptr<M0> msg0;
-      std::shared_ptr<M1> msg1;
-      std::shared_ptr<M2> msg2;
+      std::vector<std::shared_ptr<M0>> msgs;
+      msgs.reserve(max_batch_size);
       for (;;) {
         CRoutine::GetCurrentRoutine()->set_state(RoutineState::DATA_WAIT);
-        if (dv->TryFetch(msg0, msg1, msg2)) {
-          f(msg0, msg1, msg2);
+        msgs.clear();
+        if (dv->TryFetchBatch(max_batch_size, &msgs)) {
+          f(msgs);
           CRoutine::Yield(RoutineState::READY);
         } else {
           CRoutine::Yield();
@@ -116,21 +126,35 @@ RoutineFactory CreateRoutineFactory(
   return factory;
 }
 
-template <typename M0, typename M1, typename M2, typename M3, typename F>
+namespace detail {
+
+template <typename F, typename Messages, std::size_t... Is>
+void Invoke(F& f, Messages& msgs, std::index_sequence<Is...>) {  // NOLINT
+  f(std::get<Is>(msgs)...);
+}
+
+template <typename DV, typename Messages, std::size_t... Is>
+bool TryFetch(DV& dv, Messages& msgs, std::index_sequence<Is...>) {  // NOLINT
+  return dv.TryFetch(std::get<Is>(msgs)...);
+}
+
+}  // namespace detail
+
+template <typename M0, typename M1, typename... Ms, typename F>
 RoutineFactory CreateRoutineFactory(
-    F&& f, const std::shared_ptr<data::DataVisitor<M0, M1, M2, M3>>& dv) {
+    F&& f, const std::shared_ptr<data::DataVisitor<M0, M1, Ms...>>& dv) {
+  using Messages = std::tuple<std::shared_ptr<M0>, std::shared_ptr<M1>,
+                              std::shared_ptr<Ms>...>;
+  using Indices = std::index_sequence_for<M0, M1, Ms...>;
   RoutineFactory factory;
   factory.SetDataVisitor(dv);
   factory.create_routine = [=]() {
     return [=]() {
-      std::shared_ptr<M0> msg0;
-      std::shared_ptr<M1> msg1;
-      std::shared_ptr<M2> msg2;
-      std::shared_ptr<M3> msg3;
+      Messages msgs;
       for (;;) {
         CRoutine::GetCurrentRoutine()->set_state(RoutineState::DATA_WAIT);
-        if (dv->TryFetch(msg0, msg1, msg2, msg3)) {
-          f(msg0, msg1, msg2, msg3);
+        if (detail::TryFetch(*dv, msgs, Indices())) {
+          detail::Invoke(f, msgs, Indices());
           CRoutine::Yield(RoutineState::READY);
         } else {
           CRoutine::Yield();
@@ -0,0 +1,78 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/croutine/stack_watermark.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "cyber/common/environment.h"
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace croutine {
+
+using apollo::cyber::common::GetEnv;
+using apollo::cyber::common::GlobalData;
+
+StackWatermark::StackWatermark() {
+  auto watermark = GetEnv("cyber_stack_watermark");
+  if (watermark != "" && std::stoi(watermark)) {
+    enabled_ = true;
+  }
+}
+
+void StackWatermark::Update(uint64_t task_id, size_t depth,
+                            size_t stack_size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& usage = usages_[task_id];
+  usage.depth = std::max(usage.depth, depth);
+  usage.stack_size = stack_size;
+}
+
+std::unordered_map<std::string, StackWatermark::Usage>
+StackWatermark::GetUsages() {
+  std::unordered_map<std::string, Usage> usages;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& item : usages_) {
+    usages[GlobalData::GetTaskNameById(item.first)] = item.second;
+  }
+  return usages;
+}
+
+void StackWatermark::Report() {
+  std::vector<std::pair<std::string, Usage>> usages;
+  for (auto& item : GetUsages()) {
+    usages.emplace_back(item);
+  }
+  std::sort(usages.begin(), usages.end(),
+            [](const std::pair<std::string, Usage>& lhs,
+               const std::pair<std::string, Usage>& rhs) {
+              return lhs.second.depth > rhs.second.depth;
+            });
+  for (auto& usage : usages) {
+    AINFO << "croutine[" << usage.first << "] stack high water mark: "
+          << usage.second.depth << " of " << usage.second.stack_size
+          << " bytes";
+  }
+}
+
+}  // namespace croutine
+}  // namespace cyber
+}  // namespace apollo
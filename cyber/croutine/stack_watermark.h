@@ -0,0 +1,61 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_CROUTINE_STACK_WATERMARK_H_
+#define CYBER_CROUTINE_STACK_WATERMARK_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "cyber/common/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace croutine {
+
+// Deepest stack use seen per task, for sizing [stack_size] in the scheduler
+// conf. Enabled by the cyber_stack_watermark environment variable, which
+// makes every croutine paint its stack when it is created.
+class StackWatermark {
+ public:
+  struct Usage {
+    size_t depth = 0;
+    size_t stack_size = 0;
+  };
+
+  bool enabled() const { return enabled_; }
+
+  void Update(uint64_t task_id, size_t depth, size_t stack_size);
+  // keyed by task name
+  std::unordered_map<std::string, Usage> GetUsages();
+  // logs the usage of every task seen so far
+  void Report();
+
+ private:
+  bool enabled_ = false;
+  std::mutex mutex_;
+  std::unordered_map<uint64_t, Usage> usages_;
+
+  DECLARE_SINGLETON(StackWatermark)
+};
+
+}  // namespace croutine
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_CROUTINE_STACK_WATERMARK_H_
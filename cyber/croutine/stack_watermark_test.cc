@@ -0,0 +1,80 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/croutine/stack_watermark.h"
+
+#include <stdlib.h>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+#include "cyber/common/global_data.h"
+#include "cyber/croutine/croutine.h"
+
+namespace apollo {
+namespace cyber {
+namespace croutine {
+
+using apollo::cyber::common::GlobalData;
+
+void Shallow() { CRoutine::Yield(RoutineState::IO_WAIT); }
+
+void Deep() {
+  volatile char buffer[64 * 1024];
+  buffer[0] = 1;
+  buffer[sizeof(buffer) - 1] = buffer[0];
+  CRoutine::Yield(RoutineState::IO_WAIT);
+}
+
+std::shared_ptr<CRoutine> Start(const RoutineFunc& func,
+                                const std::string& name) {
+  auto cr = std::make_shared<CRoutine>(func, 256 * 1024);
+  cr->set_id(GlobalData::RegisterTaskName(name));
+  cr->set_name(name);
+  EXPECT_EQ(RoutineState::IO_WAIT, cr->Resume());
+  return cr;
+}
+
+TEST(StackWatermarkTest, high_water_mark) {
+  // must be set before the first croutine is created
+  setenv("cyber_stack_watermark", "1", 1);
+  auto watermark = StackWatermark::Instance();
+  ASSERT_TRUE(watermark->enabled());
+
+  auto shallow = Start(Shallow, "shallow");
+  auto deep = Start(Deep, "deep");
+  shallow->RecordStackUsage();
+  // released routines report on their own
+  deep = nullptr;
+
+  auto usages = watermark->GetUsages();
+  ASSERT_EQ(2, usages.size());
+  EXPECT_EQ(256 * 1024, usages["deep"].stack_size);
+  EXPECT_GT(usages["deep"].depth, 64 * 1024);
+  EXPECT_LT(usages["deep"].depth, 128 * 1024);
+  EXPECT_GT(usages["shallow"].depth, 0);
+  EXPECT_LT(usages["shallow"].depth, 16 * 1024);
+
+  // the maximum is kept across routines of the same task
+  deep = Start(Shallow, "deep");
+  deep = nullptr;
+  EXPECT_GT(watermark->GetUsages()["deep"].depth, 64 * 1024);
+  watermark->Report();
+}
+
+}  // namespace croutine
+}  // namespace cyber
+}  // namespace apollo
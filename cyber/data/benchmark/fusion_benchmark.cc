@@ -0,0 +1,120 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Fuse-and-fetch cost per message of the fusion policies: every iteration
+// fills one message per channel and fetches the fused set, one JSON object
+// per case on stdout.
+//
+//   fusion_benchmark --messages=1000000
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "cyber/data/fusion/all_latest.h"
+#include "cyber/data/fusion/approximate_time.h"
+
+DEFINE_int32(messages, 1000000, "fused sets per case");
+DEFINE_int32(queue_size, 10, "depth of every channel buffer");
+
+namespace apollo {
+namespace cyber {
+namespace data {
+
+namespace {
+
+struct Stamped {
+  struct Header {
+    double timestamp_sec() const { return 0.0; }
+  };
+  const Header& header() const { return header_; }
+  Header header_;
+};
+
+using Buffers = std::vector<ChannelBuffer<Stamped>>;
+
+Buffers MakeBuffers() {
+  Buffers buffers;
+  for (uint64_t channel_id = 0; channel_id < 4; ++channel_id) {
+    buffers.emplace_back(channel_id, new CacheBuffer<std::shared_ptr<Stamped>>(
+                                         FLAGS_queue_size));
+  }
+  return buffers;
+}
+
+template <typename Fusion>
+void Run(const std::string& name, Fusion* fusion, Buffers* buffers) {
+  // messages are preallocated, only fusion and fetch are timed, all carry
+  // the same timestamp
+  std::vector<std::shared_ptr<Stamped>> msgs;
+  for (size_t i = 0; i < buffers->size(); ++i) {
+    msgs.emplace_back(std::make_shared<Stamped>());
+  }
+  std::shared_ptr<Stamped> m0, m1, m2, m3;
+  uint64_t index = 0;
+  uint64_t fused = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < FLAGS_messages; ++i) {
+    // channel 0 last, it triggers AllLatest
+    for (size_t channel = buffers->size(); channel-- > 0;) {
+      (*buffers)[channel].Fill(msgs[channel]);
+    }
+    if (fusion->Fusion(&index, m0, m1, m2, m3)) {
+      ++index;
+      ++fused;
+    }
+  }
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+  printf(
+      "{\"fusion\": \"%s\", \"channels\": %zu, \"messages\": %d, "
+      "\"fused\": %lu, \"ns_per_set\": %.1f}\n",
+      name.c_str(), buffers->size(), FLAGS_messages, fused,
+      static_cast<double>(ns) / FLAGS_messages);
+}
+
+}  // namespace
+
+void RunAll() {
+  {
+    auto buffers = MakeBuffers();
+    fusion::AllLatest<Stamped, Stamped, Stamped, Stamped> fusion(
+        buffers[0], buffers[1], buffers[2], buffers[3]);
+    Run("all_latest", &fusion, &buffers);
+  }
+  {
+    auto buffers = MakeBuffers();
+    fusion::ExactTime<Stamped, Stamped, Stamped, Stamped> fusion(
+        buffers[0], buffers[1], buffers[2], buffers[3]);
+    Run("exact_time", &fusion, &buffers);
+  }
+}
+
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  apollo::cyber::data::RunAll();
+  return 0;
+}
@@ -0,0 +1,144 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Publish cost per message into the readers of one channel in this process,
+// one JSON object per path on stdout:
+//   transport_dispatch  IntraDispatcher::OnMessage, a listener dispatching
+//                       into the reader buffers like a receiver does
+//   intra_writer        IntraWriter::Write
+//   intra_transmitter   IntraTransmitter::Transmit, the writer plus the
+//                       IntraDispatcher without listeners
+// The reader notifiers do nothing, the wake of the reader routines is not
+// part of it.
+//
+//   intra_writer_benchmark --messages=2000000 --readers=4
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "cyber/common/util.h"
+#include "cyber/data/intra_writer.h"
+#include "cyber/transport/dispatcher/intra_dispatcher.h"
+#include "cyber/transport/transmitter/intra_transmitter.h"
+
+DEFINE_int32(messages, 2000000, "messages per path");
+DEFINE_int32(readers, 4, "reader buffers and notifiers on the channel");
+DEFINE_int32(queue_size, 10, "depth of every reader buffer");
+
+namespace apollo {
+namespace cyber {
+namespace data {
+
+namespace {
+
+using Message = int;
+using MessagePtr = std::shared_ptr<Message>;
+
+struct Readers {
+  std::vector<ChannelBuffer<Message>> buffers;
+  std::vector<std::shared_ptr<Notifier>> notifiers;
+};
+
+// registered like the buffers and the notifier of a DataVisitor
+void AddReaders(uint64_t channel_id, Readers* readers) {
+  for (int i = 0; i < FLAGS_readers; ++i) {
+    readers->buffers.emplace_back(
+        channel_id, new CacheBuffer<MessagePtr>(
+                        static_cast<uint64_t>(FLAGS_queue_size)));
+    DataDispatcher<Message>::Instance()->AddBuffer(readers->buffers.back());
+    auto notifier = std::make_shared<Notifier>();
+    notifier->callback = []() {};
+    DataNotifier::Instance()->AddNotifier(channel_id, notifier);
+    readers->notifiers.emplace_back(notifier);
+  }
+}
+
+void Run(const std::string& path, const std::function<void()>& publish) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < FLAGS_messages; ++i) {
+    publish();
+  }
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+  printf(
+      "{\"path\": \"%s\", \"readers\": %d, \"messages\": %d, "
+      "\"ns_per_message\": %.1f}\n",
+      path.c_str(), FLAGS_readers, FLAGS_messages,
+      static_cast<double>(ns) / FLAGS_messages);
+}
+
+}  // namespace
+
+void RunAll() {
+  auto msg = std::make_shared<Message>(1);
+  {
+    auto channel_id = common::Hash("/benchmark/transport_dispatch");
+    Readers readers;
+    AddReaders(channel_id, &readers);
+    proto::RoleAttributes attr;
+    attr.set_channel_id(channel_id);
+    auto dispatcher = transport::IntraDispatcher::Instance();
+    dispatcher->AddListener<Message>(
+        attr, [channel_id](const MessagePtr& msg,
+                           const transport::MessageInfo& msg_info) {
+          (void)msg_info;
+          DataDispatcher<Message>::Instance()->Dispatch(channel_id, msg);
+        });
+    transport::MessageInfo msg_info;
+    Run("transport_dispatch", [&dispatcher, channel_id, &msg, &msg_info]() {
+      dispatcher->OnMessage(channel_id, msg, msg_info);
+    });
+  }
+  {
+    auto channel_id = common::Hash("/benchmark/intra_writer");
+    Readers readers;
+    AddReaders(channel_id, &readers);
+    IntraWriter<Message> writer(channel_id);
+    Run("intra_writer", [&writer, &msg]() { writer.Write(msg); });
+  }
+  {
+    auto channel_id = common::Hash("/benchmark/intra_transmitter");
+    Readers readers;
+    AddReaders(channel_id, &readers);
+    proto::RoleAttributes attr;
+    attr.set_channel_id(channel_id);
+    std::unique_ptr<transport::Transmitter<Message>> transmitter(
+        new transport::IntraTransmitter<Message>(attr));
+    transmitter->Enable();
+    transport::MessageInfo msg_info;
+    Run("intra_transmitter", [&transmitter, &msg, &msg_info]() {
+      transmitter->Transmit(msg, msg_info);
+    });
+  }
+}
+
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  apollo::cyber::data::RunAll();
+  return 0;
+}
@@ -17,14 +17,21 @@
 #ifndef CYBER_DATA_CACHE_BUFFER_H_
 #define CYBER_DATA_CACHE_BUFFER_H_
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <memory>
-#include <mutex>
-#include <vector>
 
 namespace apollo {
 namespace cyber {
 namespace data {
 
+// Ring of the last |size| values pushed. Producers and readers never lock
+// each other out: a producer claims a position, stores the value in a node
+// of its own and swaps that node into the slot, readers copy the value out
+// of whichever node the slot points to. A replaced node is freed once every
+// reader that may still see it has left, tracked with the same two reader
+// counters RcuPtr uses, but without a producer ever waiting for them.
 template <typename T>
 class CacheBuffer {
  public:
@@ -32,67 +39,235 @@ class CacheBuffer {
   using size_type = std::size_t;
   using FusionCallback = std::function<void(const T&)>;
 
-  explicit CacheBuffer(uint64_t size) {
-    capacity_ = size + 1;
-    buffer_.resize(capacity_);
-  }
+  explicit CacheBuffer(uint64_t size)
+      : capacity_(size + 1), slots_(new Slot[size + 1]) {}
+
+  CacheBuffer(const CacheBuffer& rhs);
+  ~CacheBuffer();
 
-  CacheBuffer(const CacheBuffer& rhs) {
-    std::lock_guard<std::mutex> lg(rhs.mutex_);
-    head_ = rhs.head_;
-    tail_ = rhs.tail_;
-    buffer_ = rhs.buffer_;
-    capacity_ = rhs.capacity_;
-    fusion_callback_ = rhs.fusion_callback_;
+  T operator[](const uint64_t& pos) const { return at(pos); }
+  T at(const uint64_t& pos) const {
+    T value{};
+    TryAt(pos, &value);
+    return value;
   }
 
-  T& operator[](const uint64_t& pos) { return buffer_[GetIndex(pos)]; }
-  const T& at(const uint64_t& pos) const { return buffer_[GetIndex(pos)]; }
+  // False if |pos| was not written yet or has been overwritten meanwhile.
+  bool TryAt(const uint64_t& pos, T* value) const;
 
-  uint64_t Head() const { return head_ + 1; }
-  uint64_t Tail() const { return tail_; }
-  uint64_t Size() const { return tail_ - head_; }
+  // Copies the newest value and returns its position, 0 if there is none
+  // or the producers kept overwriting it while it was being copied.
+  uint64_t Latest(T* value) const;
+
+  uint64_t Head() const {
+    uint64_t tail = Tail();
+    return tail - std::min(tail, capacity_ - 1) + 1;
+  }
+  uint64_t Tail() const { return tail_.load(std::memory_order_acquire); }
+  uint64_t Size() const { return std::min(Tail(), capacity_ - 1); }
 
-  const T& Front() const { return buffer_[GetIndex(head_ + 1)]; }
-  const T& Back() const { return buffer_[GetIndex(tail_)]; }
+  T Front() const { return at(Head()); }
+  T Back() const { return at(Tail()); }
 
-  bool Empty() const { return tail_ == 0; }
-  bool Full() const { return capacity_ - 1 == tail_ - head_; }
+  bool Empty() const { return Tail() == 0; }
+  bool Full() const { return capacity_ - 1 == Size(); }
   uint64_t Capacity() const { return capacity_; }
 
   void SetFusionCallback(const FusionCallback& callback) {
     fusion_callback_ = callback;
   }
 
+  // Safe to call from several producers at once, which the fusion
+  // callback has to be as well.
   void Fill(const T& value) {
     if (fusion_callback_) {
       fusion_callback_(value);
     } else {
-      if (Full()) {
-        buffer_[GetIndex(head_)] = value;
-        ++head_;
-        ++tail_;
-      } else {
-        buffer_[GetIndex(tail_ + 1)] = value;
-        ++tail_;
-      }
+      Push(value);
     }
   }
 
-  std::mutex& Mutex() { return mutex_; }
+  // Stores |value| without running the fusion callback, for callbacks that
+  // keep the message in this buffer. Returns the position it was stored at.
+  uint64_t Push(const T& value);
 
  private:
+  static constexpr int kLatestTries = 16;
+  static constexpr int kRetiredLists = 3;
+
+  struct Node {
+    Node(uint64_t p, const T& v) : pos(p), value(v) {}
+    const uint64_t pos;
+    const T value;
+    Node* next = nullptr;
+  };
+
+  struct Slot {
+    std::atomic<Node*> node = {nullptr};
+  };
+
+  // Counts the reader in the current epoch for as long as it lives.
+  class ReadSection {
+   public:
+    explicit ReadSection(const CacheBuffer* buffer);
+    ~ReadSection() {
+      buffer_->readers_[parity_].fetch_sub(1, std::memory_order_release);
+    }
+
+   private:
+    const CacheBuffer* buffer_;
+    uint64_t parity_;
+  };
+
   CacheBuffer& operator=(const CacheBuffer& other) = delete;
   uint64_t GetIndex(const uint64_t& pos) const { return pos % capacity_; }
 
-  uint64_t head_ = 0;
-  uint64_t tail_ = 0;
+  void Retire(Node* node);
+  void Reclaim();
+  static void DeleteNodes(Node* node);
+
+  std::atomic<uint64_t> next_ = {0};
+  std::atomic<uint64_t> tail_ = {0};
   uint64_t capacity_ = 0;
-  std::vector<T> buffer_;
-  mutable std::mutex mutex_;
+  std::unique_ptr<Slot[]> slots_;
+
+  // Nodes replaced during epoch e wait in retired_[e % 3]. Moving to epoch
+  // e + 1 needs the readers of e - 1 gone, which makes the nodes retired
+  // in e - 2 unreachable, and their list is the one e + 1 reuses.
+  std::atomic<uint64_t> epoch_ = {0};
+  mutable std::atomic<uint64_t> readers_[2] = {};
+  std::atomic<Node*> retired_[kRetiredLists] = {};
+  std::atomic_flag reclaiming_ = ATOMIC_FLAG_INIT;
+
   FusionCallback fusion_callback_;
 };
 
+template <typename T>
+CacheBuffer<T>::ReadSection::ReadSection(const CacheBuffer* buffer)
+    : buffer_(buffer) {
+  for (;;) {
+    uint64_t epoch = buffer_->epoch_.load();
+    parity_ = epoch & 1;
+    buffer_->readers_[parity_].fetch_add(1);
+    // counted in a stale epoch, the reclaimer may not be looking at it
+    if (buffer_->epoch_.load() == epoch) {
+      return;
+    }
+    buffer_->readers_[parity_].fetch_sub(1, std::memory_order_release);
+  }
+}
+
+template <typename T>
+CacheBuffer<T>::CacheBuffer(const CacheBuffer& rhs)
+    : capacity_(rhs.capacity_), slots_(new Slot[rhs.capacity_]) {
+  ReadSection section(&rhs);
+  for (uint64_t i = 0; i < capacity_; ++i) {
+    const Node* node = rhs.slots_[i].node.load();
+    if (node != nullptr) {
+      slots_[i].node.store(new Node(node->pos, node->value),
+                           std::memory_order_relaxed);
+    }
+  }
+  next_.store(rhs.next_.load());
+  tail_.store(rhs.tail_.load());
+  fusion_callback_ = rhs.fusion_callback_;
+}
+
+template <typename T>
+CacheBuffer<T>::~CacheBuffer() {
+  for (uint64_t i = 0; i < capacity_; ++i) {
+    delete slots_[i].node.load();
+  }
+  for (auto& retired : retired_) {
+    DeleteNodes(retired.load());
+  }
+}
+
+template <typename T>
+bool CacheBuffer<T>::TryAt(const uint64_t& pos, T* value) const {
+  if (pos == 0) {
+    return false;
+  }
+  ReadSection section(this);
+  const Node* node = slots_[GetIndex(pos)].node.load();
+  if (node == nullptr || node->pos != pos) {
+    return false;
+  }
+  *value = node->value;
+  return true;
+}
+
+template <typename T>
+uint64_t CacheBuffer<T>::Latest(T* value) const {
+  for (int i = 0; i < kLatestTries; ++i) {
+    uint64_t tail = Tail();
+    if (tail == 0 || TryAt(tail, value)) {
+      return tail;
+    }
+  }
+  return 0;
+}
+
+template <typename T>
+uint64_t CacheBuffer<T>::Push(const T& value) {
+  uint64_t pos = next_.fetch_add(1) + 1;
+  Node* node = new Node(pos, value);
+  auto& slot = slots_[GetIndex(pos)].node;
+  Node* old = nullptr;
+  {
+    // another producer may retire the node we compare against
+    ReadSection section(this);
+    old = slot.load();
+    do {
+      if (old != nullptr && old->pos > pos) {
+        // a producer a full lap ahead got here first, ours is stale already
+        delete node;
+        return pos;
+      }
+    } while (!slot.compare_exchange_weak(old, node));
+  }
+
+  uint64_t tail = tail_.load();
+  while (tail < pos && !tail_.compare_exchange_weak(tail, pos)) {
+  }
+  if (old != nullptr) {
+    Retire(old);
+  }
+  return pos;
+}
+
+template <typename T>
+void CacheBuffer<T>::Retire(Node* node) {
+  auto& retired = retired_[epoch_.load() % kRetiredLists];
+  node->next = retired.load(std::memory_order_relaxed);
+  while (!retired.compare_exchange_weak(node->next, node)) {
+  }
+  Reclaim();
+}
+
+template <typename T>
+void CacheBuffer<T>::Reclaim() {
+  // one producer at a time, the others go on without waiting
+  if (reclaiming_.test_and_set(std::memory_order_acquire)) {
+    return;
+  }
+  uint64_t epoch = epoch_.load();
+  DeleteNodes(retired_[(epoch + 1) % kRetiredLists].exchange(nullptr));
+  if (readers_[(epoch + 1) & 1].load() == 0) {
+    epoch_.store(epoch + 1);
+  }
+  reclaiming_.clear(std::memory_order_release);
+}
+
+template <typename T>
+void CacheBuffer<T>::DeleteNodes(Node* node) {
+  while (node != nullptr) {
+    Node* next = node->next;
+    delete node;
+    node = next;
+  }
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
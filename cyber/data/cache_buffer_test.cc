@@ -17,9 +17,12 @@
 #include "cyber/data/cache_buffer.h"
 
 #include <gtest/gtest.h>
-#include <mutex>
+#include <atomic>
+#include <memory>
+#include <set>
 #include <thread>
 #include <utility>
+#include <vector>
 
 namespace apollo {
 namespace cyber {
@@ -52,6 +55,114 @@ TEST(CacheBufferTest, cache_buffer_test) {
   EXPECT_TRUE(buffer1.Full());
 }
 
+TEST(CacheBufferTest, concurrent_read) {
+  CacheBuffer<std::shared_ptr<uint64_t>> buffer(8);
+  std::atomic<bool> done(false);
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&buffer, &done]() {
+      std::shared_ptr<uint64_t> value;
+      while (!done.load()) {
+        auto tail = buffer.Tail();
+        if (buffer.TryAt(tail, &value)) {
+          // every slot holds the position it was written to
+          EXPECT_EQ(tail, *value);
+        }
+      }
+    });
+  }
+
+  for (uint64_t pos = 1; pos <= 100000; ++pos) {
+    buffer.Fill(std::make_shared<uint64_t>(pos));
+  }
+  done.store(true);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  EXPECT_EQ(100000, buffer.Tail());
+  EXPECT_EQ(100000 - 8 + 1, buffer.Head());
+  std::shared_ptr<uint64_t> value;
+  EXPECT_FALSE(buffer.TryAt(buffer.Head() - 2, &value));
+  EXPECT_TRUE(buffer.TryAt(buffer.Head(), &value));
+  EXPECT_EQ(buffer.Head(), *value);
+}
+
+TEST(CacheBufferTest, concurrent_latest) {
+  CacheBuffer<uint64_t> buffer(4);
+  uint64_t value = 0;
+  EXPECT_EQ(0, buffer.Latest(&value));
+  std::atomic<bool> done(false);
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&buffer, &done]() {
+      uint64_t last = 0;
+      uint64_t value = 0;
+      while (!done.load()) {
+        auto pos = buffer.Latest(&value);
+        if (pos == 0) {
+          continue;
+        }
+        EXPECT_EQ(pos, value);
+        EXPECT_LE(last, pos);
+        last = pos;
+      }
+    });
+  }
+
+  for (uint64_t pos = 1; pos <= 100000; ++pos) {
+    buffer.Fill(pos);
+  }
+  done.store(true);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(100000, buffer.Latest(&value));
+  EXPECT_EQ(100000, value);
+}
+
+TEST(CacheBufferTest, concurrent_push) {
+  CacheBuffer<std::shared_ptr<uint64_t>> buffer(64);
+  std::atomic<bool> done(false);
+
+  std::thread reader([&buffer, &done]() {
+    std::shared_ptr<uint64_t> value;
+    while (!done.load()) {
+      if (buffer.Latest(&value) != 0) {
+        EXPECT_NE(nullptr, value);
+      }
+    }
+  });
+
+  std::vector<std::thread> producers;
+  for (uint64_t i = 0; i < 4; ++i) {
+    producers.emplace_back([&buffer, i]() {
+      for (uint64_t n = 0; n < 25000; ++n) {
+        buffer.Fill(std::make_shared<uint64_t>(i * 25000 + n));
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  done.store(true);
+  reader.join();
+
+  EXPECT_EQ(100000, buffer.Tail());
+  EXPECT_TRUE(buffer.Full());
+  std::set<uint64_t> values;
+  std::shared_ptr<uint64_t> value;
+  for (auto pos = buffer.Head(); pos <= buffer.Tail(); ++pos) {
+    if (buffer.TryAt(pos, &value)) {
+      values.insert(*value);
+    }
+  }
+  // every position in the window holds a value of its own
+  EXPECT_EQ(64, values.size());
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
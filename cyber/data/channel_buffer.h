@@ -40,21 +40,25 @@ class ChannelBuffer {
   ChannelBuffer(uint64_t channel_id, BufferType* buffer)
       : channel_id_(channel_id), buffer_(buffer) {}
 
+  // False as well when a producer overwrote |*index| while it was being
+  // copied, |*index| is left as is and the next call skips ahead then.
   bool Fetch(uint64_t* index, std::shared_ptr<T>& m);  // NOLINT
 
   bool Latest(std::shared_ptr<T>& m);  // NOLINT
 
   bool FetchMulti(uint64_t fetch_size, std::vector<std::shared_ptr<T>>* vec);
 
+  // Appends up to |max_size| messages starting at |*index| (the oldest one
+  // when 0) and leaves |*index| at the next message to fetch.
+  bool FetchBatch(uint64_t* index, uint64_t max_size,
+                  std::vector<std::shared_ptr<T>>* vec);
+
   uint64_t channel_id() const { return channel_id_; }
   std::shared_ptr<BufferType> Buffer() const { return buffer_; }
 
   uint64_t Capacity() const { return buffer_->Capacity(); }
 
-  void Fill(const std::shared_ptr<T>& data) {
-    std::lock_guard<std::mutex> lg(buffer_->Mutex());
-    buffer_->Fill(data);
-  }
+  void Fill(const std::shared_ptr<T>& data) { buffer_->Fill(data); }
 
  private:
   uint64_t channel_id_;
@@ -64,7 +68,6 @@ class ChannelBuffer {
 template <typename T>
 bool ChannelBuffer<T>::Fetch(uint64_t* index,
                              std::shared_ptr<T>& m) {  // NOLINT
-  std::lock_guard<std::mutex> lock(buffer_->Mutex());
   if (buffer_->Empty()) {
     return false;
   }
@@ -80,36 +83,64 @@ bool ChannelBuffer<T>::Fetch(uint64_t* index,
           << *index << "] current_index[" << buffer_->Tail() << "] ";
     *index = buffer_->Tail();
   }
-  m = buffer_->at(*index);
-  return true;
+  // a producer may overwrite the slot right after the checks above
+  return buffer_->TryAt(*index, &m);
 }
 
 template <typename T>
 bool ChannelBuffer<T>::Latest(std::shared_ptr<T>& m) {  // NOLINT
-  std::lock_guard<std::mutex> lock(buffer_->Mutex());
+  return buffer_->Latest(&m) != 0;
+}
+
+template <typename T>
+bool ChannelBuffer<T>::FetchMulti(uint64_t fetch_size,
+                                  std::vector<std::shared_ptr<T>>* vec) {
   if (buffer_->Empty()) {
     return false;
   }
 
-  m = buffer_->Back();
+  auto tail = buffer_->Tail();
+  auto num = std::min(buffer_->Size(), fetch_size);
+  vec->reserve(num);
+  std::shared_ptr<T> m;
+  for (auto index = tail - num + 1; index <= tail; ++index) {
+    // skip what the producer overwrote while copying
+    if (buffer_->TryAt(index, &m)) {
+      vec->emplace_back(std::move(m));
+    }
+  }
   return true;
 }
 
 template <typename T>
-bool ChannelBuffer<T>::FetchMulti(uint64_t fetch_size,
+bool ChannelBuffer<T>::FetchBatch(uint64_t* index, uint64_t max_size,
                                   std::vector<std::shared_ptr<T>>* vec) {
-  std::lock_guard<std::mutex> lock(buffer_->Mutex());
   if (buffer_->Empty()) {
     return false;
   }
 
-  auto num = std::min(buffer_->Size(), fetch_size);
-  vec->reserve(num);
-  for (auto index = buffer_->Tail() - num + 1; index <= buffer_->Tail();
-       ++index) {
-    vec->emplace_back(buffer_->at(index));
+  auto tail = buffer_->Tail();
+  if (*index == 0) {
+    *index = buffer_->Head();
+  } else if (*index == tail + 1) {
+    return false;
+  } else if (*index < buffer_->Head()) {
+    auto interval = buffer_->Head() - *index;
+    AWARN << "channel[" << GlobalData::GetChannelById(channel_id_) << "] "
+          << "read buffer overflow, drop_message[" << interval << "] pre_index["
+          << *index << "] current_index[" << buffer_->Head() << "] ";
+    *index = buffer_->Head();
   }
-  return true;
+  auto size = vec->size();
+  std::shared_ptr<T> m;
+  for (uint64_t fetched = 0; *index <= tail && fetched < max_size;
+       ++*index, ++fetched) {
+    // skip what the producer overwrote while copying
+    if (buffer_->TryAt(*index, &m)) {
+      vec->emplace_back(std::move(m));
+    }
+  }
+  return vec->size() > size;
 }
 
 }  // namespace data
@@ -97,6 +97,39 @@ TEST(ChannelBufferTest, FetchMulti) {
   EXPECT_EQ(2, *vector[1]);
 }
 
+TEST(ChannelBufferTest, FetchBatch) {
+  auto cache_buffer = new CacheBuffer<std::shared_ptr<int>>(4);
+  auto buffer = std::make_shared<ChannelBuffer<int>>(channel0, cache_buffer);
+  std::vector<std::shared_ptr<int>> vector;
+  uint64_t index = 0;
+  EXPECT_FALSE(buffer->FetchBatch(&index, 2, &vector));
+  for (int i = 1; i <= 3; ++i) {
+    buffer->Fill(std::make_shared<int>(i));
+  }
+  EXPECT_TRUE(buffer->FetchBatch(&index, 2, &vector));
+  EXPECT_EQ(2, vector.size());
+  EXPECT_EQ(1, *vector[0]);
+  EXPECT_EQ(2, *vector[1]);
+  EXPECT_EQ(3, index);
+
+  vector.clear();
+  EXPECT_TRUE(buffer->FetchBatch(&index, 2, &vector));
+  EXPECT_EQ(1, vector.size());
+  EXPECT_EQ(3, *vector[0]);
+  EXPECT_FALSE(buffer->FetchBatch(&index, 2, &vector));
+
+  // overflow restarts from the oldest message still buffered
+  vector.clear();
+  for (int i = 4; i <= 10; ++i) {
+    buffer->Fill(std::make_shared<int>(i));
+  }
+  EXPECT_TRUE(buffer->FetchBatch(&index, 10, &vector));
+  EXPECT_EQ(4, vector.size());
+  EXPECT_EQ(7, *vector[0]);
+  EXPECT_EQ(10, *vector[3]);
+  EXPECT_EQ(11, index);
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
@@ -0,0 +1,138 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+
+#ifndef CYBER_DATA_CONFLATED_BUFFER_H_
+#define CYBER_DATA_CONFLATED_BUFFER_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+#include "cyber/data/data_notifier.h"
+#include "cyber/message/message_traits.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+
+// Holds only the newest message of a channel for readers that want the
+// latest state. A newer message replaces one not fetched yet, and messages
+// filled in serialized form are parsed only when they are fetched, so
+// superseded ones are never deserialized.
+template <typename T>
+class ConflatedBuffer {
+ public:
+  explicit ConflatedBuffer(uint64_t channel_id) : channel_id_(channel_id) {}
+
+  void Fill(const std::shared_ptr<T>& msg);
+  void Fill(const std::shared_ptr<std::string>& serialized);
+
+  bool Fetch(std::shared_ptr<T>& msg);  // NOLINT
+
+  uint64_t channel_id() const { return channel_id_; }
+
+  // messages replaced before anyone fetched them
+  uint64_t dropped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+  }
+
+ private:
+  // must be called with mutex_ held, true if the buffer was empty
+  bool Replace();
+
+  uint64_t channel_id_;
+  mutable std::mutex mutex_;
+  bool pending_ = false;
+  uint64_t dropped_ = 0;
+  std::shared_ptr<T> msg_;
+  std::shared_ptr<std::string> serialized_;
+};
+
+template <typename T>
+bool ConflatedBuffer<T>::Replace() {
+  msg_.reset();
+  serialized_.reset();
+  if (pending_) {
+    ++dropped_;
+    return false;
+  }
+  pending_ = true;
+  return true;
+}
+
+template <typename T>
+void ConflatedBuffer<T>::Fill(const std::shared_ptr<T>& msg) {
+  bool was_empty = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    was_empty = Replace();
+    msg_ = msg;
+  }
+  // a pending message has already woken the reader
+  if (was_empty) {
+    DataNotifier::Instance()->Notify(channel_id_);
+  }
+}
+
+template <typename T>
+void ConflatedBuffer<T>::Fill(const std::shared_ptr<std::string>& serialized) {
+  bool was_empty = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    was_empty = Replace();
+    serialized_ = serialized;
+  }
+  if (was_empty) {
+    DataNotifier::Instance()->Notify(channel_id_);
+  }
+}
+
+template <typename T>
+bool ConflatedBuffer<T>::Fetch(std::shared_ptr<T>& msg) {  // NOLINT
+  std::shared_ptr<std::string> serialized;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!pending_) {
+      return false;
+    }
+    pending_ = false;
+    if (msg_ != nullptr) {
+      msg = std::move(msg_);
+      return true;
+    }
+    serialized = std::move(serialized_);
+  }
+
+  auto parsed = std::make_shared<T>();
+  if (!message::ParseFromString(*serialized, parsed.get())) {
+    AERROR << "failed to parse message of channel "
+           << common::GlobalData::GetChannelById(channel_id_);
+    return false;
+  }
+  msg = std::move(parsed);
+  return true;
+}
+
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_DATA_CONFLATED_BUFFER_H_
@@ -0,0 +1,83 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+
+#include "cyber/data/conflated_buffer.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+#include "cyber/data/data_visitor.h"
+#include "cyber/proto/unit_test.pb.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+
+using apollo::cyber::proto::Chatter;
+
+std::shared_ptr<std::string> Serialize(uint64_t seq) {
+  Chatter chatter;
+  chatter.set_seq(seq);
+  auto serialized = std::make_shared<std::string>();
+  chatter.SerializeToString(serialized.get());
+  return serialized;
+}
+
+TEST(ConflatedBufferTest, keep_latest) {
+  auto buffer = std::make_shared<ConflatedBuffer<Chatter>>(1);
+  std::shared_ptr<Chatter> msg;
+  EXPECT_FALSE(buffer->Fetch(msg));
+
+  for (uint64_t seq = 1; seq <= 3; ++seq) {
+    buffer->Fill(Serialize(seq));
+  }
+  EXPECT_EQ(2, buffer->dropped());
+  EXPECT_TRUE(buffer->Fetch(msg));
+  EXPECT_EQ(3, msg->seq());
+  EXPECT_FALSE(buffer->Fetch(msg));
+
+  auto chatter = std::make_shared<Chatter>();
+  chatter->set_seq(4);
+  buffer->Fill(chatter);
+  EXPECT_TRUE(buffer->Fetch(msg));
+  EXPECT_EQ(chatter, msg);
+
+  buffer->Fill(std::make_shared<std::string>("\xff"));
+  EXPECT_FALSE(buffer->Fetch(msg));
+}
+
+TEST(ConflatedBufferTest, data_visitor) {
+  auto buffer = std::make_shared<ConflatedBuffer<Chatter>>(2);
+  DataVisitor<Chatter> dv(buffer);
+  int notified = 0;
+  dv.RegisterNotifyCallback([&notified]() { ++notified; });
+
+  std::shared_ptr<Chatter> msg;
+  EXPECT_FALSE(dv.TryFetch(msg));
+  buffer->Fill(Serialize(1));
+  buffer->Fill(Serialize(2));
+  // the reader is woken once per message it can fetch
+  EXPECT_EQ(1, notified);
+  EXPECT_TRUE(dv.TryFetch(msg));
+  EXPECT_EQ(2, msg->seq());
+  EXPECT_FALSE(dv.TryFetch(msg));
+}
+
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
@@ -17,13 +17,15 @@
 #ifndef CYBER_DATA_DATA_DISPATCHER_H_
 #define CYBER_DATA_DATA_DISPATCHER_H_
 
+#include <algorithm>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include "cyber/common/log.h"
 #include "cyber/common/macros.h"
-#include "cyber/base/atomic_rw_lock.h"
+#include "cyber/base/rcu_ptr.h"
 #include "cyber/data/channel_buffer.h"
 #include "cyber/state.h"
 // #include "cyber/time/time.h"
@@ -33,25 +35,44 @@ namespace cyber {
 namespace data {
 
 // using apollo::cyber::Time;
-using apollo::cyber::base::AtomicRWLock;
-using apollo::cyber::base::ReadLockGuard;
-using apollo::cyber::base::WriteLockGuard;
+using apollo::cyber::base::RcuPtr;
 
 template <typename T>
 class DataDispatcher {
  public:
-  using BufferVector =
-      std::vector<std::weak_ptr<CacheBuffer<std::shared_ptr<T>>>>;
+  using BufferType = CacheBuffer<std::shared_ptr<T>>;
+  using BufferVector = std::vector<std::weak_ptr<BufferType>>;
+
+  // The reader buffers of one channel. An entry is never dropped, so a
+  // writer may hold on to it instead of looking the channel up per message.
+  struct Channel {
+    RcuPtr<BufferVector> buffers;
+  };
+
   ~DataDispatcher() {}
 
   void AddBuffer(const ChannelBuffer<T>& channel_buffer);
 
+  // Once this returns no Dispatch or Fill touches the buffer any more.
+  void RemoveBuffer(const ChannelBuffer<T>& channel_buffer);
+
   bool Dispatch(const uint64_t channel_id, const std::shared_ptr<T>& msg);
 
+  bool GetBuffers(const uint64_t channel_id, BufferVector* buffers);
+
+  // the entry of |channel_id|, added if the channel has none yet
+  std::shared_ptr<Channel> GetChannel(const uint64_t channel_id);
+
+  // Fills |msg| into the buffers of |channel|, false if it has none.
+  static bool Fill(const Channel& channel, const std::shared_ptr<T>& msg);
+
  private:
+  using ChannelMap = std::unordered_map<uint64_t, std::shared_ptr<Channel>>;
+
+  std::shared_ptr<Channel> FindChannel(const uint64_t channel_id) const;
+
   DataNotifier* notifier_ = DataNotifier::Instance();
-  AtomicRWLock buffers_map_mutex_;
-  std::unordered_map<uint64_t, BufferVector> buffers_map_;
+  RcuPtr<ChannelMap> channels_;
 
   DECLARE_SINGLETON(DataDispatcher)
 };
@@ -59,18 +80,89 @@ class DataDispatcher {
 template <typename T>
 inline DataDispatcher<T>::DataDispatcher() {}
 
+template <typename T>
+std::shared_ptr<typename DataDispatcher<T>::Channel>
+DataDispatcher<T>::FindChannel(const uint64_t channel_id) const {
+  auto channels = channels_.Read();
+  auto iter = channels->find(channel_id);
+  if (iter == channels->end()) {
+    return nullptr;
+  }
+  return iter->second;
+}
+
+template <typename T>
+std::shared_ptr<typename DataDispatcher<T>::Channel>
+DataDispatcher<T>::GetChannel(const uint64_t channel_id) {
+  auto channel = FindChannel(channel_id);
+  if (channel != nullptr) {
+    return channel;
+  }
+  channels_.Update([channel_id](ChannelMap* channels) {
+    auto& entry = (*channels)[channel_id];
+    if (entry == nullptr) {
+      entry = std::make_shared<Channel>();
+    }
+  });
+  return FindChannel(channel_id);
+}
+
 template <typename T>
 void DataDispatcher<T>::AddBuffer(const ChannelBuffer<T>& channel_buffer) {
   auto buffer = channel_buffer.Buffer();
-  const uint64_t channel_id = channel_buffer.channel_id();
-
-  WriteLockGuard<AtomicRWLock> lock(buffers_map_mutex_);
-  auto iter = buffers_map_.find(channel_id);
-  if (iter == buffers_map_.end()) {
-    buffers_map_.emplace(channel_id, BufferVector{ buffer });
-  } else {
-    iter->second.emplace_back(buffer);
+  auto channel = GetChannel(channel_buffer.channel_id());
+  channel->buffers.Update([&buffer](BufferVector* buffers) {
+    // drop the buffers of readers that went away without RemoveBuffer
+    auto expired = [](const std::weak_ptr<BufferType>& b) {
+      return b.expired();
+    };
+    buffers->erase(std::remove_if(buffers->begin(), buffers->end(), expired),
+                   buffers->end());
+    buffers->emplace_back(buffer);
+  });
+}
+
+template <typename T>
+void DataDispatcher<T>::RemoveBuffer(const ChannelBuffer<T>& channel_buffer) {
+  auto buffer = channel_buffer.Buffer();
+  auto channel = FindChannel(channel_buffer.channel_id());
+  if (channel == nullptr) {
+    return;
+  }
+  channel->buffers.Update([&buffer](BufferVector* buffers) {
+    auto removed = [&buffer](const std::weak_ptr<BufferType>& b) {
+      auto locked = b.lock();
+      return locked == nullptr || locked == buffer;
+    };
+    buffers->erase(std::remove_if(buffers->begin(), buffers->end(), removed),
+                   buffers->end());
+  });
+}
+
+template <typename T>
+bool DataDispatcher<T>::GetBuffers(const uint64_t channel_id,
+                                   BufferVector* buffers) {
+  auto channel = FindChannel(channel_id);
+  if (channel == nullptr) {
+    return false;
+  }
+  *buffers = *channel->buffers.Read();
+  return !buffers->empty();
+}
+
+template <typename T>
+bool DataDispatcher<T>::Fill(const Channel& channel,
+                             const std::shared_ptr<T>& msg) {
+  auto buffers = channel.buffers.Read();
+  if (buffers->empty()) {
+    return false;
+  }
+  for (auto& buffer_wptr : *buffers) {
+    if (auto buffer = buffer_wptr.lock()) {
+      buffer->Fill(msg);
+    }
   }
+  return true;
 }
 
 template <typename T>
@@ -79,21 +171,12 @@ bool DataDispatcher<T>::Dispatch(const uint64_t channel_id,
   if (apollo::cyber::IsShutdown()) {
     return false;
   }
-  BufferVector buffers;
   {
-    ReadLockGuard<AtomicRWLock> lock(buffers_map_mutex_);
-    auto iter = buffers_map_.find(channel_id);
-    if (iter == buffers_map_.end()) {
+    auto channels = channels_.Read();
+    auto iter = channels->find(channel_id);
+    if (iter == channels->end() || !Fill(*iter->second, msg)) {
       return false;
     }
-    buffers = iter->second;
-  }
-
-  for (auto& buffer_wptr : buffers) {
-    if (auto buffer = buffer_wptr.lock()) {
-      std::lock_guard<std::mutex> lock(buffer->Mutex());
-      buffer->Fill(msg);
-    }
   }
   return notifier_->Notify(channel_id);
 }
@@ -26,10 +26,6 @@ namespace apollo {
 namespace cyber {
 namespace data {
 
-template <typename T>
-using BufferVector =
-    std::vector<std::weak_ptr<CacheBuffer<std::shared_ptr<T>>>>;
-
 auto channel0 = common::Hash("/channel0");
 auto channel1 = common::Hash("/channel1");
 
@@ -57,6 +53,54 @@ TEST(DataDispatcher, Dispatch) {
   EXPECT_TRUE(dispatcher->Dispatch(channel0, msg));
 }
 
+TEST(DataDispatcher, RemoveBuffer) {
+  auto channel2 = common::Hash("/channel2");
+  auto buffer0 =
+      ChannelBuffer<int>(channel2, new CacheBuffer<std::shared_ptr<int>>(10));
+  auto buffer1 =
+      ChannelBuffer<int>(channel2, new CacheBuffer<std::shared_ptr<int>>(10));
+  auto dispatcher = DataDispatcher<int>::Instance();
+  auto msg = std::make_shared<int>(1);
+
+  dispatcher->AddBuffer(buffer0);
+  dispatcher->AddBuffer(buffer1);
+  dispatcher->Dispatch(channel2, msg);
+  EXPECT_EQ(1, buffer0.Buffer()->Size());
+  EXPECT_EQ(1, buffer1.Buffer()->Size());
+
+  dispatcher->RemoveBuffer(buffer0);
+  dispatcher->Dispatch(channel2, msg);
+  EXPECT_EQ(1, buffer0.Buffer()->Size());
+  EXPECT_EQ(2, buffer1.Buffer()->Size());
+
+  dispatcher->RemoveBuffer(buffer1);
+  DataDispatcher<int>::BufferVector buffers;
+  EXPECT_FALSE(dispatcher->GetBuffers(channel2, &buffers));
+  EXPECT_FALSE(dispatcher->Dispatch(channel2, msg));
+}
+
+TEST(DataDispatcher, DroppedBuffer) {
+  auto channel3 = common::Hash("/channel3");
+  auto dispatcher = DataDispatcher<int>::Instance();
+  std::weak_ptr<CacheBuffer<std::shared_ptr<int>>> dropped;
+  {
+    auto buffer =
+        ChannelBuffer<int>(channel3, new CacheBuffer<std::shared_ptr<int>>(10));
+    dispatcher->AddBuffer(buffer);
+    dropped = buffer.Buffer();
+  }
+  // the dispatcher does not keep a reader's buffer alive
+  EXPECT_TRUE(dropped.expired());
+  dispatcher->Dispatch(channel3, std::make_shared<int>(1));
+
+  auto buffer =
+      ChannelBuffer<int>(channel3, new CacheBuffer<std::shared_ptr<int>>(10));
+  dispatcher->AddBuffer(buffer);
+  DataDispatcher<int>::BufferVector buffers;
+  EXPECT_TRUE(dispatcher->GetBuffers(channel3, &buffers));
+  EXPECT_EQ(1, buffers.size());
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
@@ -17,6 +17,8 @@
 #ifndef CYBER_DATA_DATA_NOTIFIER_H_
 #define CYBER_DATA_DATA_NOTIFIER_H_
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -25,7 +27,7 @@
 #include "cyber/common/log.h"
 #include "cyber/common/macros.h"
 #include "cyber/data/cache_buffer.h"
-#include "cyber/base/atomic_rw_lock.h"
+#include "cyber/base/rcu_ptr.h"
 // #include "cyber/event/perf_event_cache.h"
 // #include "cyber/time/time.h"
 
@@ -34,9 +36,7 @@ namespace cyber {
 namespace data {
 
 // using apollo::cyber::Time;
-using apollo::cyber::base::AtomicRWLock;
-using apollo::cyber::base::ReadLockGuard;
-using apollo::cyber::base::WriteLockGuard;
+using apollo::cyber::base::RcuPtr;
 
 struct Notifier {
   std::function<void()> callback;
@@ -45,44 +45,105 @@ struct Notifier {
 class DataNotifier {
  public:
   using NotifyVector = std::vector<std::shared_ptr<Notifier>>;
+
+  // The notifiers of one channel, kept like DataDispatcher::Channel.
+  struct Channel {
+    RcuPtr<NotifyVector> notifiers;
+  };
+
   ~DataNotifier() {}
 
   void AddNotifier(uint64_t channel_id,
                    const std::shared_ptr<Notifier>& notifier);
 
+  // Once this returns no Notify runs the notifier any more.
+  void RemoveNotifier(uint64_t channel_id,
+                      const std::shared_ptr<Notifier>& notifier);
+
   bool Notify(const uint64_t channel_id);
 
+  bool GetNotifiers(const uint64_t channel_id, NotifyVector* notifiers);
+
+  // the entry of |channel_id|, added if the channel has none yet
+  std::shared_ptr<Channel> GetChannel(const uint64_t channel_id);
+
+  // Runs the notifiers of |channel|, false if it has none.
+  static bool Notify(const Channel& channel);
+
  private:
-  AtomicRWLock notifies_map_mutex_;
-  std::unordered_map<uint64_t, NotifyVector> notifies_map_;
+  using ChannelMap = std::unordered_map<uint64_t, std::shared_ptr<Channel>>;
+
+  std::shared_ptr<Channel> FindChannel(const uint64_t channel_id) const;
+
+  RcuPtr<ChannelMap> channels_;
 
   DECLARE_SINGLETON(DataNotifier)
 };
 
 inline DataNotifier::DataNotifier() {}
 
+inline std::shared_ptr<DataNotifier::Channel> DataNotifier::FindChannel(
+    const uint64_t channel_id) const {
+  auto channels = channels_.Read();
+  auto iter = channels->find(channel_id);
+  if (iter == channels->cend()) {
+    return nullptr;
+  }
+  return iter->second;
+}
+
+inline std::shared_ptr<DataNotifier::Channel> DataNotifier::GetChannel(
+    const uint64_t channel_id) {
+  auto channel = FindChannel(channel_id);
+  if (channel != nullptr) {
+    return channel;
+  }
+  channels_.Update([channel_id](ChannelMap* channels) {
+    auto& entry = (*channels)[channel_id];
+    if (entry == nullptr) {
+      entry = std::make_shared<Channel>();
+    }
+  });
+  return FindChannel(channel_id);
+}
+
 inline void DataNotifier::AddNotifier(
     uint64_t channel_id, const std::shared_ptr<Notifier>& notifier) {
-  WriteLockGuard<AtomicRWLock> lock(notifies_map_mutex_);
-  auto iter = notifies_map_.find(channel_id);
-  if (iter == notifies_map_.end()) {
-    notifies_map_.emplace(channel_id, std::vector<std::shared_ptr<Notifier>>{notifier});
-  } else {
-    iter->second.emplace_back(notifier);
+  GetChannel(channel_id)->notifiers.Update(
+      [&notifier](NotifyVector* notifiers) {
+        notifiers->emplace_back(notifier);
+      });
+}
+
+inline void DataNotifier::RemoveNotifier(
+    uint64_t channel_id, const std::shared_ptr<Notifier>& notifier) {
+  auto channel = FindChannel(channel_id);
+  if (channel == nullptr) {
+    return;
   }
+  channel->notifiers.Update([&notifier](NotifyVector* notifiers) {
+    notifiers->erase(
+        std::remove(notifiers->begin(), notifiers->end(), notifier),
+        notifiers->end());
+  });
 }
 
-inline bool DataNotifier::Notify(const uint64_t channel_id) {
-  NotifyVector notifiers;
-  {
-    ReadLockGuard<AtomicRWLock> lock(notifies_map_mutex_);
-    auto iter = notifies_map_.find(channel_id);
-    if (iter == notifies_map_.cend()) {
-      return false;
-    }
-    notifiers = iter->second;
+inline bool DataNotifier::GetNotifiers(const uint64_t channel_id,
+                                       NotifyVector* notifiers) {
+  auto channel = FindChannel(channel_id);
+  if (channel == nullptr) {
+    return false;
   }
-  for (auto& notifier : notifiers) {
+  *notifiers = *channel->notifiers.Read();
+  return !notifiers->empty();
+}
+
+inline bool DataNotifier::Notify(const Channel& channel) {
+  auto notifiers = channel.notifiers.Read();
+  if (notifiers->empty()) {
+    return false;
+  }
+  for (auto& notifier : *notifiers) {
     if (notifier && notifier->callback) {
       notifier->callback();
     }
@@ -90,6 +151,15 @@ inline bool DataNotifier::Notify(const uint64_t channel_id) {
   return true;
 }
 
+inline bool DataNotifier::Notify(const uint64_t channel_id) {
+  auto channels = channels_.Read();
+  auto iter = channels->find(channel_id);
+  if (iter == channels->cend()) {
+    return false;
+  }
+  return Notify(*iter->second);
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
@@ -14,19 +14,25 @@
  * limitations under the License.
  *****************************************************************************/
 
+
 #ifndef CYBER_DATA_DATA_VISITOR_H_
 #define CYBER_DATA_DATA_VISITOR_H_
 
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "cyber/common/log.h"
 #include "cyber/data/channel_buffer.h"
+#include "cyber/data/conflated_buffer.h"
 #include "cyber/data/data_dispatcher.h"
 #include "cyber/data/data_visitor_base.h"
 #include "cyber/data/fusion/all_latest.h"
+#include "cyber/data/fusion/approximate_time.h"
 #include "cyber/data/fusion/data_fusion.h"
 
 namespace apollo {
@@ -40,41 +46,91 @@ struct VisitorConfig {
   uint32_t queue_size;
 };
 
+enum class FusionPolicy {
+  // every message on channel 0 is paired with the latest of the others
+  ALL_LATEST,
+  // one message per channel, the oldest and the newest timestamp at most
+  // tolerance_ns apart
+  APPROXIMATE_TIME,
+  // one message per channel, all with the same timestamp
+  EXACT_TIME,
+};
+
+struct FusionConfig {
+  FusionConfig() = default;
+  FusionConfig(FusionPolicy fusion_policy, uint64_t tolerance)
+      : policy(fusion_policy), tolerance_ns(tolerance) {}
+  FusionPolicy policy = FusionPolicy::ALL_LATEST;
+  uint64_t tolerance_ns = 0;
+};
+
 template <typename T>
 using BufferType = CacheBuffer<std::shared_ptr<T>>;
 
-template <typename M0, typename M1 = NullType, typename M2 = NullType,
-          typename M3 = NullType>
+// Every message type needs a fusion::MessageTimestamp, message types
+// without one only go with the ALL_LATEST of DataVisitor(configs).
+template <typename... Ms>
+fusion::DataFusion<Ms...>* CreateFusion(const FusionConfig& config,
+                                        const ChannelBuffer<Ms>&... buffers) {
+  switch (config.policy) {
+    case FusionPolicy::APPROXIMATE_TIME:
+      return new fusion::ApproximateTime<Ms...>(config.tolerance_ns,
+                                                buffers...);
+    case FusionPolicy::EXACT_TIME:
+      return new fusion::ExactTime<Ms...>(buffers...);
+    default:
+      return new fusion::AllLatest<Ms...>(buffers...);
+  }
+}
+
+// Fuses the channels of |configs|, one per message type, into sets handed
+// out by TryFetch.
+template <typename M0, typename... Ms>
 class DataVisitor : public DataVisitorBase {
  public:
+  // Pairs every message on channel 0 with the latest of the others.
   explicit DataVisitor(const std::vector<VisitorConfig>& configs)
-      : buffer_m0_(configs[0].channel_id,
-                   new BufferType<M0>(configs[0].queue_size)),
-        buffer_m1_(configs[1].channel_id,
-                   new BufferType<M1>(configs[1].queue_size)),
-        buffer_m2_(configs[2].channel_id,
-                   new BufferType<M2>(configs[2].queue_size)),
-        buffer_m3_(configs[3].channel_id,
-                   new BufferType<M3>(configs[3].queue_size)) {
-    DataDispatcher<M0>::Instance()->AddBuffer(buffer_m0_);
-    DataDispatcher<M1>::Instance()->AddBuffer(buffer_m1_);
-    DataDispatcher<M2>::Instance()->AddBuffer(buffer_m2_);
-    DataDispatcher<M3>::Instance()->AddBuffer(buffer_m3_);
-    data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
-    data_fusion_ = new fusion::AllLatest<M0, M1, M2, M3>(
-        buffer_m0_, buffer_m1_, buffer_m2_, buffer_m3_);
+      : buffers_(MakeBuffers(configs, Indices())) {
+    AddBuffers(Indices());
+    data_notifier_->AddNotifier(std::get<0>(buffers_).channel_id(), notifier_);
+    data_fusion_ = MakeAllLatest(Indices());
+  }
+
+  // Time based policies match messages on their fusion::MessageTimestamp,
+  // so this one only exists when every message type has one.
+  template <bool kStamped = fusion::HasMessageTimestamp<M0, Ms...>(),
+            typename std::enable_if<kStamped, int>::type = 0>
+  DataVisitor(const std::vector<VisitorConfig>& configs,
+              const FusionConfig& fusion_config)
+      : fusion_config_(fusion_config),
+        buffers_(MakeBuffers(configs, Indices())) {
+    AddBuffers(Indices());
+    data_notifier_->AddNotifier(std::get<0>(buffers_).channel_id(), notifier_);
+    data_fusion_ = MakeFusion(Indices());
+    if (fusion_config_.policy != FusionPolicy::ALL_LATEST) {
+      // any channel may complete a set
+      AddNotifiers(Indices());
+    }
   }
 
   ~DataVisitor() {
+    // the fusion callback runs inside Fill, stop the dispatchers first
+    if (fusion_config_.policy != FusionPolicy::ALL_LATEST) {
+      RemoveNotifiers(Indices());
+    } else {
+      data_notifier_->RemoveNotifier(std::get<0>(buffers_).channel_id(),
+                                     notifier_);
+    }
+    RemoveBuffers(Indices());
     if (data_fusion_) {
       delete data_fusion_;
       data_fusion_ = nullptr;
     }
   }
 
-  bool TryFetch(std::shared_ptr<M0>& m0, std::shared_ptr<M1>& m1,    // NOLINT
-                std::shared_ptr<M2>& m2, std::shared_ptr<M3>& m3) {  // NOLINT
-    if (data_fusion_->Fusion(&next_msg_index_, m0, m1, m2, m3)) {
+  bool TryFetch(std::shared_ptr<M0>& m0,      // NOLINT
+                std::shared_ptr<Ms>&... ms) {  // NOLINT
+    if (data_fusion_->Fusion(&next_msg_index_, m0, ms...)) {
       next_msg_index_++;
       return true;
     }
@@ -82,91 +138,73 @@ class DataVisitor : public DataVisitorBase {
   }
 
  private:
-  fusion::DataFusion<M0, M1, M2, M3>* data_fusion_ = nullptr;
-  ChannelBuffer<M0> buffer_m0_;
-  ChannelBuffer<M1> buffer_m1_;
-  ChannelBuffer<M2> buffer_m2_;
-  ChannelBuffer<M3> buffer_m3_;
-};
+  using Indices = std::index_sequence_for<M0, Ms...>;
+  using Buffers = std::tuple<ChannelBuffer<M0>, ChannelBuffer<Ms>...>;
 
-template <typename M0, typename M1, typename M2>
-class DataVisitor<M0, M1, M2, NullType> : public DataVisitorBase {
- public:
-  explicit DataVisitor(const std::vector<VisitorConfig>& configs)
-      : buffer_m0_(configs[0].channel_id,
-                   new BufferType<M0>(configs[0].queue_size)),
-        buffer_m1_(configs[1].channel_id,
-                   new BufferType<M1>(configs[1].queue_size)),
-        buffer_m2_(configs[2].channel_id,
-                   new BufferType<M2>(configs[2].queue_size)) {
-    DataDispatcher<M0>::Instance()->AddBuffer(buffer_m0_);
-    DataDispatcher<M1>::Instance()->AddBuffer(buffer_m1_);
-    DataDispatcher<M2>::Instance()->AddBuffer(buffer_m2_);
-    data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
-    data_fusion_ =
-        new fusion::AllLatest<M0, M1, M2>(buffer_m0_, buffer_m1_, buffer_m2_);
+  template <std::size_t I>
+  using MessageType =
+      typename std::tuple_element<I, std::tuple<M0, Ms...>>::type;
+
+  template <std::size_t... Is>
+  static Buffers MakeBuffers(const std::vector<VisitorConfig>& configs,
+                             std::index_sequence<Is...>) {
+    return Buffers(ChannelBuffer<MessageType<Is>>(
+        configs[Is].channel_id,
+        new BufferType<MessageType<Is>>(configs[Is].queue_size))...);
   }
 
-  ~DataVisitor() {
-    if (data_fusion_) {
-      delete data_fusion_;
-      data_fusion_ = nullptr;
-    }
+  template <std::size_t... Is>
+  fusion::DataFusion<M0, Ms...>* MakeFusion(std::index_sequence<Is...>) {
+    return CreateFusion<M0, Ms...>(fusion_config_, std::get<Is>(buffers_)...);
   }
 
-  bool TryFetch(std::shared_ptr<M0>& m0, std::shared_ptr<M1>& m1,  // NOLINT
-                std::shared_ptr<M2>& m2) {                         // NOLINT
-    if (data_fusion_->Fusion(&next_msg_index_, m0, m1, m2)) {
-      next_msg_index_++;
-      return true;
-    }
-    return false;
+  template <std::size_t... Is>
+  fusion::DataFusion<M0, Ms...>* MakeAllLatest(std::index_sequence<Is...>) {
+    return new fusion::AllLatest<M0, Ms...>(std::get<Is>(buffers_)...);
   }
 
- private:
-  fusion::DataFusion<M0, M1, M2>* data_fusion_ = nullptr;
-  ChannelBuffer<M0> buffer_m0_;
-  ChannelBuffer<M1> buffer_m1_;
-  ChannelBuffer<M2> buffer_m2_;
-};
+  template <std::size_t... Is>
+  void AddBuffers(std::index_sequence<Is...>) {
+    int expand[] = {(DataDispatcher<MessageType<Is>>::Instance()->AddBuffer(
+                         std::get<Is>(buffers_)),
+                     0)...};
+    (void)expand;
+  }
 
-template <typename M0, typename M1>
-class DataVisitor<M0, M1, NullType, NullType> : public DataVisitorBase {
- public:
-  explicit DataVisitor(const std::vector<VisitorConfig>& configs)
-      : buffer_m0_(configs[0].channel_id,
-                   new BufferType<M0>(configs[0].queue_size)),
-        buffer_m1_(configs[1].channel_id,
-                   new BufferType<M1>(configs[1].queue_size)) {
-    DataDispatcher<M0>::Instance()->AddBuffer(buffer_m0_);
-    DataDispatcher<M1>::Instance()->AddBuffer(buffer_m1_);
-    data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
-    data_fusion_ = new fusion::AllLatest<M0, M1>(buffer_m0_, buffer_m1_);
+  template <std::size_t... Is>
+  void RemoveBuffers(std::index_sequence<Is...>) {
+    int expand[] = {(DataDispatcher<MessageType<Is>>::Instance()->RemoveBuffer(
+                         std::get<Is>(buffers_)),
+                     0)...};
+    (void)expand;
   }
 
-  ~DataVisitor() {
-    if (data_fusion_) {
-      delete data_fusion_;
-      data_fusion_ = nullptr;
-    }
+  // channel 0 is registered by the constructor
+  template <std::size_t... Is>
+  void AddNotifiers(std::index_sequence<Is...>) {
+    int expand[] = {(Is == 0 ? 0
+                             : (data_notifier_->AddNotifier(
+                                    std::get<Is>(buffers_).channel_id(),
+                                    notifier_),
+                                0))...};
+    (void)expand;
   }
 
-  bool TryFetch(std::shared_ptr<M0>& m0, std::shared_ptr<M1>& m1) {  // NOLINT
-    if (data_fusion_->Fusion(&next_msg_index_, m0, m1)) {
-      next_msg_index_++;
-      return true;
-    }
-    return false;
+  template <std::size_t... Is>
+  void RemoveNotifiers(std::index_sequence<Is...>) {
+    int expand[] = {(data_notifier_->RemoveNotifier(
+                         std::get<Is>(buffers_).channel_id(), notifier_),
+                     0)...};
+    (void)expand;
   }
 
- private:
-  fusion::DataFusion<M0, M1>* data_fusion_ = nullptr;
-  ChannelBuffer<M0> buffer_m0_;
-  ChannelBuffer<M1> buffer_m1_;
+  FusionConfig fusion_config_;
+  fusion::DataFusion<M0, Ms...>* data_fusion_ = nullptr;
+  Buffers buffers_;
 };
 
 template <typename M0>
-class DataVisitor<M0, NullType, NullType, NullType> : public DataVisitorBase {
+class DataVisitor<M0> : public DataVisitorBase {
  public:
   explicit DataVisitor(const VisitorConfig& configs)
       : buffer_(configs.channel_id, new BufferType<M0>(configs.queue_size)) {
@@ -180,7 +218,25 @@ class DataVisitor<M0, NullType, NullType, NullType> : public DataVisitorBase {
     data_notifier_->AddNotifier(buffer_.channel_id(), notifier_);
   }
 
+  // Only the newest message is fetched, see ConflatedBuffer. The buffer is
+  // filled by the caller, usually from a receiver's listeners.
+  explicit DataVisitor(const std::shared_ptr<ConflatedBuffer<M0>>& conflated)
+      : buffer_(conflated->channel_id(), new BufferType<M0>(0)),
+        conflated_(conflated) {
+    data_notifier_->AddNotifier(conflated_->channel_id(), notifier_);
+  }
+
+  ~DataVisitor() {
+    data_notifier_->RemoveNotifier(buffer_.channel_id(), notifier_);
+    if (conflated_ == nullptr) {
+      DataDispatcher<M0>::Instance()->RemoveBuffer(buffer_);
+    }
+  }
+
   bool TryFetch(std::shared_ptr<M0>& m0) {  // NOLINT
+    if (conflated_ != nullptr) {
+      return conflated_->Fetch(m0);
+    }
     if (buffer_.Fetch(&next_msg_index_, m0)) {
       next_msg_index_++;
       return true;
@@ -188,8 +244,23 @@ class DataVisitor<M0, NullType, NullType, NullType> : public DataVisitorBase {
     return false;
   }
 
+  // appends up to |max_size| pending messages to |msgs|
+  bool TryFetchBatch(uint64_t max_size,
+                     std::vector<std::shared_ptr<M0>>* msgs) {
+    if (conflated_ != nullptr) {
+      std::shared_ptr<M0> msg;
+      if (!conflated_->Fetch(msg)) {
+        return false;
+      }
+      msgs->emplace_back(std::move(msg));
+      return true;
+    }
+    return buffer_.FetchBatch(&next_msg_index_, max_size, msgs);
+  }
+
  private:
   ChannelBuffer<M0> buffer_;
+  std::shared_ptr<ConflatedBuffer<M0>> conflated_;
 };
 
 }  // namespace data
@@ -19,6 +19,7 @@
 #include <gtest/gtest.h>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "cyber/common/log.h"
@@ -38,6 +39,16 @@ auto channel1 = str_hash("/channel1");
 auto channel2 = str_hash("/channel2");
 auto channel3 = str_hash("/channel3");
 
+struct StampedMessage {
+  struct Header {
+    double timestamp_sec() const { return stamp; }
+    double stamp;
+  };
+  explicit StampedMessage(double stamp) : header_{stamp} {}
+  const Header& header() const { return header_; }
+  Header header_;
+};
+
 void DispatchMessage(uint64_t channel_id, int num) {
   for (int i = 0; i < num; ++i) {
     auto raw_msg = std::make_shared<RawMessage>();
@@ -137,6 +148,53 @@ TEST(DataVisitorTest, four_channel) {
   EXPECT_FALSE(dv->TryFetch(msg0, msg1, msg2, msg3));
 }
 
+TEST(DataVisitorTest, five_channel) {
+  auto dv = std::make_shared<DataVisitor<RawMessage, RawMessage, RawMessage,
+                                         RawMessage, RawMessage>>(
+      InitConfigs(5));
+  auto channel4 = str_hash("/channel4");
+
+  std::shared_ptr<RawMessage> msg0;
+  std::shared_ptr<RawMessage> msg1;
+  std::shared_ptr<RawMessage> msg2;
+  std::shared_ptr<RawMessage> msg3;
+  std::shared_ptr<RawMessage> msg4;
+  DispatchMessage(channel0, 1);
+  DispatchMessage(channel1, 1);
+  DispatchMessage(channel2, 1);
+  DispatchMessage(channel3, 1);
+  EXPECT_FALSE(dv->TryFetch(msg0, msg1, msg2, msg3, msg4));
+  DispatchMessage(channel4, 1);
+  EXPECT_FALSE(dv->TryFetch(msg0, msg1, msg2, msg3, msg4));
+  DispatchMessage(channel0, 1);
+  EXPECT_TRUE(dv->TryFetch(msg0, msg1, msg2, msg3, msg4));
+  EXPECT_FALSE(dv->TryFetch(msg0, msg1, msg2, msg3, msg4));
+}
+
+TEST(DataVisitorTest, fusion_policy) {
+  // RawMessage carries no timestamp, only ALL_LATEST is there for it
+  EXPECT_FALSE((std::is_constructible<DataVisitor<RawMessage, RawMessage>,
+                                      std::vector<VisitorConfig>,
+                                      FusionConfig>::value));
+
+  auto configs = InitConfigs(2);
+  DataVisitor<StampedMessage, StampedMessage> dv(
+      configs, FusionConfig(FusionPolicy::APPROXIMATE_TIME, 10000000));
+  auto dispatcher = DataDispatcher<StampedMessage>::Instance();
+  std::shared_ptr<StampedMessage> msg0;
+  std::shared_ptr<StampedMessage> msg1;
+  dispatcher->Dispatch(configs[1].channel_id,
+                       std::make_shared<StampedMessage>(1.0));
+  dispatcher->Dispatch(configs[0].channel_id,
+                       std::make_shared<StampedMessage>(1.5));
+  EXPECT_FALSE(dv.TryFetch(msg0, msg1));
+  dispatcher->Dispatch(configs[0].channel_id,
+                       std::make_shared<StampedMessage>(1.005));
+  EXPECT_TRUE(dv.TryFetch(msg0, msg1));
+  EXPECT_EQ(1.005, msg0->header().timestamp_sec());
+  EXPECT_EQ(1.0, msg1->header().timestamp_sec());
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
@@ -0,0 +1,64 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_DATA_FUSION_APPROXIMATE_TIME_H_
+#define CYBER_DATA_FUSION_APPROXIMATE_TIME_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "cyber/data/channel_buffer.h"
+#include "cyber/data/fusion/data_fusion.h"
+#include "cyber/data/fusion/time_synchronizer.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+namespace fusion {
+
+// Emits a set as soon as the newest arrival completes one whose timestamps
+// span at most |tolerance_ns|, see TimeSynchronizer.
+template <typename M0, typename... Ms>
+class ApproximateTime : public DataFusion<M0, Ms...> {
+ public:
+  ApproximateTime(uint64_t tolerance_ns, const ChannelBuffer<M0>& buffer_0,
+                  const ChannelBuffer<Ms>&... buffers)
+      : synchronizer_(tolerance_ns, buffer_0, buffers...) {}
+
+  bool Fusion(uint64_t* index, std::shared_ptr<M0>& m0,
+              std::shared_ptr<Ms>&... ms) override {
+    return synchronizer_.Fetch(index, m0, ms...);
+  }
+
+ private:
+  TimeSynchronizer<M0, Ms...> synchronizer_;
+};
+
+// Only messages carrying the very same timestamp are grouped.
+template <typename M0, typename... Ms>
+class ExactTime : public ApproximateTime<M0, Ms...> {
+ public:
+  ExactTime(const ChannelBuffer<M0>& buffer_0,
+            const ChannelBuffer<Ms>&... buffers)
+      : ApproximateTime<M0, Ms...>(0, buffer_0, buffers...) {}
+};
+
+}  // namespace fusion
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_DATA_FUSION_APPROXIMATE_TIME_H_
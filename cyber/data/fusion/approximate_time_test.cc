@@ -0,0 +1,172 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/data/fusion/approximate_time.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+#include "cyber/message/raw_message.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+
+using apollo::cyber::message::RawMessage;
+
+struct StampedMessage {
+  struct Header {
+    double timestamp_sec() const { return stamp; }
+    double stamp;
+  };
+  StampedMessage(double stamp, const std::string& data)
+      : header_{stamp}, content(data) {}
+  const Header& header() const { return header_; }
+  Header header_;
+  std::string content;
+};
+
+std::shared_ptr<StampedMessage> Stamped(double stamp, const std::string& data) {
+  return std::make_shared<StampedMessage>(stamp, data);
+}
+
+TEST(ApproximateTimeTest, timestamp) {
+  EXPECT_TRUE(fusion::HasMessageTimestamp<StampedMessage>());
+  EXPECT_FALSE(
+      (fusion::HasMessageTimestamp<StampedMessage, RawMessage>()));
+  EXPECT_EQ(1500000000, fusion::MessageTimestamp<StampedMessage>::Get(
+                            StampedMessage(1.5, "")));
+}
+
+TEST(ApproximateTimeTest, two_channels) {
+  auto cache0 = new CacheBuffer<std::shared_ptr<StampedMessage>>(10);
+  auto cache1 = new CacheBuffer<std::shared_ptr<StampedMessage>>(10);
+  ChannelBuffer<StampedMessage> buffer0(0, cache0);
+  ChannelBuffer<StampedMessage> buffer1(1, cache1);
+  std::shared_ptr<StampedMessage> m0;
+  std::shared_ptr<StampedMessage> m1;
+  uint64_t index = 0;
+  // 10ms
+  fusion::ApproximateTime<StampedMessage, StampedMessage> fusion(10000000,
+                                                                 buffer0,
+                                                                 buffer1);
+
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+  cache0->Fill(Stamped(1.0, "0-0"));
+  cache0->Fill(Stamped(1.1, "0-1"));
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+
+  // the second channel completes the set with the closest pending message
+  cache1->Fill(Stamped(1.095, "1-0"));
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1));
+  EXPECT_EQ(index, 1);
+  index++;
+  EXPECT_EQ("0-1", m0->content);
+  EXPECT_EQ("1-0", m1->content);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+
+  // out of tolerance, stays pending
+  cache1->Fill(Stamped(1.2, "1-1"));
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+  cache0->Fill(Stamped(1.25, "0-2"));
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+  cache0->Fill(Stamped(1.205, "0-3"));
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1));
+  EXPECT_EQ(index, 2);
+  index++;
+  EXPECT_EQ("0-3", m0->content);
+  EXPECT_EQ("1-1", m1->content);
+
+  // matched messages are not used twice
+  cache0->Fill(Stamped(1.2, "0-4"));
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+}
+
+TEST(ApproximateTimeTest, pairwise_spread) {
+  auto cache0 = new CacheBuffer<std::shared_ptr<StampedMessage>>(10);
+  auto cache1 = new CacheBuffer<std::shared_ptr<StampedMessage>>(10);
+  auto cache2 = new CacheBuffer<std::shared_ptr<StampedMessage>>(10);
+  ChannelBuffer<StampedMessage> buffer0(0, cache0);
+  ChannelBuffer<StampedMessage> buffer1(1, cache1);
+  ChannelBuffer<StampedMessage> buffer2(2, cache2);
+  std::shared_ptr<StampedMessage> m0;
+  std::shared_ptr<StampedMessage> m1;
+  std::shared_ptr<StampedMessage> m2;
+  uint64_t index = 0;
+  // 10ms
+  fusion::ApproximateTime<StampedMessage, StampedMessage, StampedMessage>
+      fusion(10000000, buffer0, buffer1, buffer2);
+
+  // 0.995 is the closest to the pivot but 13ms away from 1.008
+  cache1->Fill(Stamped(0.995, "1-0"));
+  cache1->Fill(Stamped(1.007, "1-1"));
+  cache2->Fill(Stamped(1.008, "2-0"));
+  cache0->Fill(Stamped(1.0, "0-0"));
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1, m2));
+  EXPECT_EQ("0-0", m0->content);
+  EXPECT_EQ("1-1", m1->content);
+  EXPECT_EQ("2-0", m2->content);
+  index++;
+
+  // each one within 10ms of the pivot, 20ms apart from each other
+  cache1->Fill(Stamped(1.99, "1-2"));
+  cache2->Fill(Stamped(2.01, "2-1"));
+  cache0->Fill(Stamped(2.0, "0-1"));
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1, m2));
+}
+
+TEST(ApproximateTimeTest, exact_time) {
+  auto cache0 = new CacheBuffer<std::shared_ptr<StampedMessage>>(10);
+  auto cache1 = new CacheBuffer<std::shared_ptr<StampedMessage>>(10);
+  auto cache2 = new CacheBuffer<std::shared_ptr<StampedMessage>>(10);
+  ChannelBuffer<StampedMessage> buffer0(0, cache0);
+  ChannelBuffer<StampedMessage> buffer1(1, cache1);
+  ChannelBuffer<StampedMessage> buffer2(2, cache2);
+  std::shared_ptr<StampedMessage> m0;
+  std::shared_ptr<StampedMessage> m1;
+  std::shared_ptr<StampedMessage> m2;
+  uint64_t index = 0;
+  fusion::ExactTime<StampedMessage, StampedMessage, StampedMessage> fusion(
+      buffer0, buffer1, buffer2);
+
+  cache0->Fill(Stamped(2.0, "0-0"));
+  cache1->Fill(Stamped(2.0, "1-0"));
+  cache2->Fill(Stamped(2.001, "2-0"));
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1, m2));
+  cache2->Fill(Stamped(2.0, "2-1"));
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1, m2));
+  EXPECT_EQ("0-0", m0->content);
+  EXPECT_EQ("1-0", m1->content);
+  EXPECT_EQ("2-1", m2->content);
+  index++;
+
+  // overflow of the output keeps the sets aligned
+  for (int i = 0; i < 30; ++i) {
+    auto stamp = 3.0 + i;
+    cache1->Fill(Stamped(stamp, "1-" + std::to_string(i)));
+    cache2->Fill(Stamped(stamp, "2-" + std::to_string(i)));
+    cache0->Fill(Stamped(stamp, "0-" + std::to_string(i)));
+  }
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1, m2));
+  EXPECT_EQ("0-29", m0->content);
+  EXPECT_EQ("1-29", m1->content);
+  EXPECT_EQ("2-29", m2->content);
+}
+
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,81 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_DATA_FUSION_FUSION_BUFFER_H_
+#define CYBER_DATA_FUSION_FUSION_BUFFER_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+#include "cyber/data/cache_buffer.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+namespace fusion {
+
+// Ring of fused sets. The sets live in a CacheBuffer, so a producer never
+// waits for a reader copying a set out and readers never wait at all.
+template <typename... Ms>
+class FusionBuffer {
+ public:
+  using MessageSet = std::tuple<std::shared_ptr<Ms>...>;
+
+  FusionBuffer(uint64_t channel_id, uint64_t size)
+      : channel_id_(channel_id), ring_(std::max(size, uint64_t(1))) {}
+
+  void Fill(const MessageSet& set) { ring_.Push(set); }
+
+  // Same index semantics as ChannelBuffer::Fetch.
+  bool Fetch(uint64_t* index, std::shared_ptr<Ms>&... msgs) {  // NOLINT
+    uint64_t tail = ring_.Tail();
+    if (tail == 0) {
+      return false;
+    }
+
+    if (*index == 0) {
+      *index = tail;
+    } else if (*index == tail + 1) {
+      return false;
+    } else if (*index < ring_.Head()) {
+      AWARN << "channel[" << common::GlobalData::GetChannelById(channel_id_)
+            << "] read buffer overflow, drop_message[" << tail - *index
+            << "] pre_index[" << *index << "] current_index[" << tail << "] ";
+      *index = tail;
+    }
+    MessageSet set;
+    if (!ring_.TryAt(*index, &set)) {
+      return false;
+    }
+    std::tie(msgs...) = std::move(set);
+    return true;
+  }
+
+ private:
+  uint64_t channel_id_;
+  CacheBuffer<MessageSet> ring_;
+};
+
+}  // namespace fusion
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_DATA_FUSION_FUSION_BUFFER_H_
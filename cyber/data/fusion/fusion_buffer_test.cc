@@ -0,0 +1,107 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/data/fusion/fusion_buffer.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace apollo {
+namespace cyber {
+namespace data {
+namespace fusion {
+
+TEST(FusionBufferTest, fill_and_fetch) {
+  FusionBuffer<int, std::string> buffer(0, 3);
+  std::shared_ptr<int> m0;
+  std::shared_ptr<std::string> m1;
+  uint64_t index = 0;
+  EXPECT_FALSE(buffer.Fetch(&index, m0, m1));
+
+  buffer.Fill(std::make_tuple(std::make_shared<int>(1),
+                              std::make_shared<std::string>("1")));
+  EXPECT_TRUE(buffer.Fetch(&index, m0, m1));
+  EXPECT_EQ(1, index);
+  EXPECT_EQ(1, *m0);
+  EXPECT_EQ("1", *m1);
+  index++;
+  EXPECT_FALSE(buffer.Fetch(&index, m0, m1));
+
+  // overflow jumps to the latest set
+  for (int i = 2; i <= 10; ++i) {
+    buffer.Fill(std::make_tuple(std::make_shared<int>(i),
+                                std::make_shared<std::string>(
+                                    std::to_string(i))));
+  }
+  EXPECT_TRUE(buffer.Fetch(&index, m0, m1));
+  EXPECT_EQ(10, index);
+  EXPECT_EQ(10, *m0);
+  EXPECT_EQ("10", *m1);
+
+  // sets still in the ring are fetched in order
+  index = 8;
+  EXPECT_TRUE(buffer.Fetch(&index, m0, m1));
+  EXPECT_EQ(8, index);
+  EXPECT_EQ(8, *m0);
+}
+
+TEST(FusionBufferTest, concurrent_fill) {
+  FusionBuffer<int, int> buffer(0, 4);
+  std::atomic<bool> done(false);
+
+  std::thread reader([&buffer, &done]() {
+    std::shared_ptr<int> m0;
+    std::shared_ptr<int> m1;
+    uint64_t index = 0;
+    while (!done.load()) {
+      if (buffer.Fetch(&index, m0, m1)) {
+        // a set is never seen half written
+        EXPECT_EQ(*m0, *m1);
+        ++index;
+      }
+    }
+  });
+
+  std::vector<std::thread> producers;
+  for (int i = 0; i < 2; ++i) {
+    producers.emplace_back([&buffer]() {
+      for (int n = 0; n < 20000; ++n) {
+        auto m = std::make_shared<int>(n);
+        buffer.Fill(std::make_tuple(m, m));
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  done.store(true);
+  reader.join();
+
+  std::shared_ptr<int> m0;
+  std::shared_ptr<int> m1;
+  uint64_t index = 0;
+  EXPECT_TRUE(buffer.Fetch(&index, m0, m1));
+  EXPECT_EQ(40000, index);
+}
+
+}  // namespace fusion
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,245 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_DATA_FUSION_TIME_SYNCHRONIZER_H_
+#define CYBER_DATA_FUSION_TIME_SYNCHRONIZER_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cyber/data/channel_buffer.h"
+#include "cyber/data/fusion/fusion_buffer.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+namespace fusion {
+
+// Timestamp in nanoseconds the synchronizer matches messages on. Messages
+// with a header().timestamp_sec() are supported out of the box, specialize
+// this for other types.
+template <typename T, typename Enable = void>
+struct MessageTimestamp : std::false_type {};
+
+template <typename T>
+struct MessageTimestamp<
+    T, decltype(void(std::declval<const T&>().header().timestamp_sec()))>
+    : std::true_type {
+  static uint64_t Get(const T& message) {
+    return static_cast<uint64_t>(message.header().timestamp_sec() * 1e9);
+  }
+};
+
+template <typename... Ts>
+constexpr bool HasMessageTimestamp() {
+  bool stamped[] = {MessageTimestamp<Ts>::value...};
+  for (bool s : stamped) {
+    if (!s) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Groups one message per channel whose timestamps are all within
+// |tolerance_ns|, the oldest and the newest of a set included. Every
+// arriving message is matched against the messages still pending on the
+// other channels, so whichever channel completes a set triggers it. Pending
+// messages stay in the channels' own cache buffers and matched sets go to a
+// FusionBuffer.
+template <typename... Ms>
+class TimeSynchronizer {
+  static_assert(HasMessageTimestamp<Ms...>(),
+                "TimeSynchronizer needs a MessageTimestamp for every type");
+
+ public:
+  TimeSynchronizer(uint64_t tolerance_ns, const ChannelBuffer<Ms>&... buffers)
+      : tolerance_ns_(tolerance_ns),
+        inputs_(buffers...),
+        output_(std::get<0>(inputs_).channel_id(),
+                std::get<0>(inputs_).Capacity() - uint64_t(1)) {
+    consumed_.fill(0);
+    Connect(Indices());
+  }
+
+  bool Fetch(uint64_t* index, std::shared_ptr<Ms>&... msgs) {  // NOLINT
+    return output_.Fetch(index, msgs...);
+  }
+
+ private:
+  using Indices = std::index_sequence_for<Ms...>;
+  using MessageSet = typename FusionBuffer<Ms...>::MessageSet;
+  using Positions = std::array<uint64_t, sizeof...(Ms)>;
+
+  struct Candidate {
+    uint64_t stamp;
+    uint64_t pos;
+  };
+
+  template <std::size_t I>
+  using MessageType = typename std::tuple_element<I, std::tuple<Ms...>>::type;
+
+  template <std::size_t... Is>
+  void Connect(std::index_sequence<Is...>) {
+    int expand[] = {(ConnectChannel<Is>(), 0)...};
+    (void)expand;
+  }
+
+  template <std::size_t I>
+  void ConnectChannel() {
+    std::get<I>(inputs_).Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<MessageType<I>>& msg) {
+          OnMessage<I>(msg);
+        });
+  }
+
+  // runs inside the input buffer's Fill, maybe on several producers at once
+  template <std::size_t I>
+  void OnMessage(const std::shared_ptr<MessageType<I>>& msg) {
+    auto buffer = std::get<I>(inputs_).Buffer();
+    uint64_t pushed = buffer->Push(msg);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t pivot = MessageTimestamp<MessageType<I>>::Get(*msg);
+    Collect(pivot, Indices());
+    candidates_[I].assign(1, Candidate{pivot, pushed});
+    Positions positions;
+    MessageSet set;
+    if (!SelectWindow(pivot, &positions) ||
+        !Load(positions, &set, Indices())) {
+      return;
+    }
+    output_.Fill(set);
+    consumed_ = positions;
+  }
+
+  template <std::size_t... Is>
+  void Collect(uint64_t pivot, std::index_sequence<Is...>) {
+    int expand[] = {(CollectChannel<Is>(pivot), 0)...};
+    (void)expand;
+  }
+
+  // the pending messages of channel I within tolerance of |pivot|
+  template <std::size_t I>
+  void CollectChannel(uint64_t pivot) {
+    auto& candidates = candidates_[I];
+    candidates.clear();
+    auto buffer = std::get<I>(inputs_).Buffer();
+    uint64_t tail = buffer->Tail();
+    std::shared_ptr<MessageType<I>> msg;
+    for (uint64_t pos = std::max(buffer->Head(), consumed_[I] + 1); pos <= tail;
+         ++pos) {
+      if (!buffer->TryAt(pos, &msg)) {
+        continue;
+      }
+      uint64_t stamp = MessageTimestamp<MessageType<I>>::Get(*msg);
+      if (Distance(stamp, pivot) <= tolerance_ns_) {
+        candidates.push_back(Candidate{stamp, pos});
+      }
+    }
+  }
+
+  // A set fits in a window of |tolerance_ns_| starting at its oldest stamp,
+  // which is the pivot's or an older candidate's. Every window holding the
+  // pivot is tried, per channel the candidate closest to the pivot is taken
+  // and the set with the least spread wins.
+  bool SelectWindow(uint64_t pivot, Positions* positions) const {
+    bool found = false;
+    uint64_t best_spread = 0;
+    for (auto& lows : candidates_) {
+      for (auto& low : lows) {
+        if (low.stamp > pivot) {
+          continue;
+        }
+        uint64_t room = std::numeric_limits<uint64_t>::max() - low.stamp;
+        uint64_t high = low.stamp + std::min(tolerance_ns_, room);
+        Positions picked;
+        uint64_t oldest = pivot;
+        uint64_t newest = pivot;
+        if (!PickWindow(pivot, low.stamp, high, &picked, &oldest, &newest)) {
+          continue;
+        }
+        if (!found || newest - oldest < best_spread) {
+          found = true;
+          best_spread = newest - oldest;
+          *positions = picked;
+        }
+      }
+    }
+    return found;
+  }
+
+  bool PickWindow(uint64_t pivot, uint64_t low, uint64_t high,
+                  Positions* picked, uint64_t* oldest,
+                  uint64_t* newest) const {
+    for (std::size_t i = 0; i < candidates_.size(); ++i) {
+      const Candidate* closest = nullptr;
+      for (auto& candidate : candidates_[i]) {
+        if (candidate.stamp < low || candidate.stamp > high) {
+          continue;
+        }
+        if (closest == nullptr || Distance(candidate.stamp, pivot) <
+                                      Distance(closest->stamp, pivot)) {
+          closest = &candidate;
+        }
+      }
+      if (closest == nullptr) {
+        return false;
+      }
+      (*picked)[i] = closest->pos;
+      *oldest = std::min(*oldest, closest->stamp);
+      *newest = std::max(*newest, closest->stamp);
+    }
+    return true;
+  }
+
+  // false if a producer overwrote one of them meanwhile
+  template <std::size_t... Is>
+  bool Load(const Positions& positions, MessageSet* set,
+            std::index_sequence<Is...>) const {
+    bool loaded[] = {std::get<Is>(inputs_).Buffer()->TryAt(
+        positions[Is], &std::get<Is>(*set))...};
+    return std::all_of(std::begin(loaded), std::end(loaded),
+                       [](bool l) { return l; });
+  }
+
+  static uint64_t Distance(uint64_t a, uint64_t b) {
+    return a > b ? a - b : b - a;
+  }
+
+  uint64_t tolerance_ns_;
+  std::tuple<ChannelBuffer<Ms>...> inputs_;
+  FusionBuffer<Ms...> output_;
+  Positions consumed_;
+  // per channel, reused so that matching does not allocate once warm
+  std::array<std::vector<Candidate>, sizeof...(Ms)> candidates_;
+  std::mutex mutex_;
+};
+
+}  // namespace fusion
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_DATA_FUSION_TIME_SYNCHRONIZER_H_
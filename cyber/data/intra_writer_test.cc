@@ -0,0 +1,95 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/data/intra_writer.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "cyber/common/util.h"
+#include "cyber/data/data_visitor.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+
+TEST(IntraWriterTest, Write) {
+  auto channel_id = common::Hash("/intra_writer");
+  IntraWriter<int> writer(channel_id);
+  auto msg = std::make_shared<int>(1);
+  EXPECT_FALSE(writer.Write(msg));
+
+  ChannelBuffer<int> buffer0(channel_id,
+                             new CacheBuffer<std::shared_ptr<int>>(10));
+  DataDispatcher<int>::Instance()->AddBuffer(buffer0);
+  EXPECT_FALSE(writer.Write(msg));
+  EXPECT_EQ(1, buffer0.Buffer()->Size());
+
+  int notified = 0;
+  auto notifier = std::make_shared<Notifier>();
+  notifier->callback = [&notified]() { ++notified; };
+  DataNotifier::Instance()->AddNotifier(channel_id, notifier);
+  EXPECT_TRUE(writer.Write(msg));
+  EXPECT_EQ(2, buffer0.Buffer()->Size());
+  EXPECT_EQ(1, notified);
+
+  // a reader added after the first write is picked up
+  ChannelBuffer<int> buffer1(channel_id,
+                             new CacheBuffer<std::shared_ptr<int>>(10));
+  DataDispatcher<int>::Instance()->AddBuffer(buffer1);
+  EXPECT_TRUE(writer.Write(std::make_shared<int>(2)));
+  EXPECT_EQ(3, buffer0.Buffer()->Size());
+  EXPECT_EQ(1, buffer1.Buffer()->Size());
+  EXPECT_EQ(2, *buffer1.Buffer()->Back());
+  EXPECT_EQ(2, notified);
+
+  // other channels are untouched
+  IntraWriter<int> other(common::Hash("/intra_writer_other"));
+  EXPECT_FALSE(other.Write(msg));
+  EXPECT_EQ(3, buffer0.Buffer()->Size());
+}
+
+TEST(IntraWriterTest, WriteWhileVisitorDestroyed) {
+  auto channel0 = common::Hash("/intra_writer_race0");
+  auto channel1 = common::Hash("/intra_writer_race1");
+  std::vector<VisitorConfig> configs = {{channel0, 10}, {channel1, 10}};
+
+  // the fusion of a visitor is called from the fills of channel 0 and freed
+  // right after RemoveBuffer, no write may still be filling by then
+  std::atomic<bool> stop = {false};
+  std::thread writer([channel0, &stop]() {
+    IntraWriter<int> writer(channel0);
+    auto msg = std::make_shared<int>(1);
+    while (!stop.load()) {
+      writer.Write(msg);
+    }
+  });
+  for (int i = 0; i < 500; ++i) {
+    DataVisitor<int, int> visitor(configs);
+    DataDispatcher<int>::Instance()->Dispatch(channel1,
+                                              std::make_shared<int>(i));
+    std::this_thread::yield();
+  }
+  stop = true;
+  writer.join();
+}
+
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
@@ -16,13 +16,18 @@
 
 #include "cyber/init.h"
 
+#include <fcntl.h>
 #include <libgen.h>
 #include <stdio.h>
 #include <sys/types.h>
 #include <time.h>
 #include <unistd.h>
+#include <atomic>
+#include <cerrno>
 #include <csignal>
+#include <cstring>
 #include <string>
+#include <thread>
 
 #include "cyber/binary.h"
 #include "cyber/common/global_data.h"
@@ -32,6 +37,7 @@
 #include "cyber/service_discovery/topology_manager.h"
 #include "cyber/task/task.h"
 #include "cyber/timer/timing_wheel.h"
+#include "cyber/transport/rtps/payload_compressor.h"
 #include "cyber/transport/transport.h"
 
 namespace apollo {
@@ -39,12 +45,19 @@ namespace cyber {
 
 using apollo::cyber::scheduler::Scheduler;
 using apollo::cyber::service_discovery::TopologyManager;
+using apollo::cyber::transport::CompressionStatistics;
 
 namespace {
 
 bool g_atexit_registered = false;
 std::mutex g_mutex;
 logger::AsyncLogger* async_logger = nullptr;
+std::thread stats_thread;
+std::atomic<bool> stats_running = {false};
+// kept open for the life of the process, a late signal never hits a
+// closed descriptor
+int stats_pipe[2] = {-1, -1};
+struct sigaction prev_stats_action;
 
 void InitLogger(const char* binary_name) {
   const char* slash = strrchr(binary_name, '/');
@@ -73,6 +86,69 @@ void StopLogger() {
   }
 }
 
+void OnStatsSignal(int sig) {
+  (void)sig;
+  int saved_errno = errno;
+  char byte = 0;
+  // a full pipe has reports pending already
+  ssize_t ret = write(stats_pipe[1], &byte, 1);
+  (void)ret;
+  errno = saved_errno;
+}
+
+// SIGUSR2 logs the runtime accounting of the scheduler's tasks, the idle
+// polling of its processors and the payload compression of rtps channels. Whichever thread takes the signal, the handler
+// only writes to a pipe that a thread of its own reads, so the report needs
+// not be async-signal-safe and no signal mask is touched.
+void StartStatsDumper() {
+  if (stats_pipe[0] < 0) {
+    if (pipe2(stats_pipe, O_CLOEXEC) != 0) {
+      AWARN << "stats dumper pipe failed: " << strerror(errno);
+      return;
+    }
+    fcntl(stats_pipe[1], F_SETFL, O_NONBLOCK);
+  }
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = OnStatsSignal;
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_RESTART;
+  sigaction(SIGUSR2, &action, &prev_stats_action);
+
+  stats_running.store(true);
+  stats_thread = std::thread([]() {
+    char byte = 0;
+    for (;;) {
+      ssize_t ret = read(stats_pipe[0], &byte, 1);
+      if (ret < 0 && errno == EINTR) {
+        continue;
+      }
+      if (ret <= 0 || !stats_running.load()) {
+        break;
+      }
+      auto sched = scheduler::Instance();
+      sched->ReportRoutineStats();
+      sched->ReportProcessorStats();
+      auto compression = CompressionStatistics::Instance()->DebugString();
+      if (!compression.empty()) {
+        AINFO << "rtps payload compression:\n" << compression;
+      }
+    }
+  });
+}
+
+void StopStatsDumper() {
+  if (!stats_thread.joinable()) {
+    return;
+  }
+  sigaction(SIGUSR2, &prev_stats_action, nullptr);
+  stats_running.store(false);
+  char byte = 0;
+  ssize_t ret = write(stats_pipe[1], &byte, 1);
+  (void)ret;
+  stats_thread.join();
+}
+
 }  // namespace
 
 void OnShutdown(int sig) {
@@ -93,6 +169,7 @@ bool Init(const char* binary_name) {
   InitLogger(binary_name);
   auto thread = const_cast<std::thread*>(async_logger->LogThread());
   scheduler::Instance()->SetInnerThreadAttr("async_log", thread);
+  StartStatsDumper();
   std::signal(SIGINT, OnShutdown);
   // Register exit handlers
   if (!g_atexit_registered) {
@@ -112,6 +189,7 @@ void Clear() {
   if (GetState() == STATE_SHUTDOWN || GetState() == STATE_UNINITIALIZED) {
     return;
   }
+  StopStatsDumper();
   TaskManager::CleanUp();
   TimingWheel::CleanUp();
   scheduler::CleanUp();
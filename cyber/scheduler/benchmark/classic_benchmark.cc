@@ -0,0 +1,191 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Throughput of a classic group with and without work stealing. Every task
+// sums its own buffer on each activation, so where it runs decides how much
+// of it is still cached. Producers keep waking random tasks the way
+// SchedulerClassic::NotifyProcessor does until --activations ran, one JSON
+// object per case on stdout. cache_misses are counted for the whole process
+// through perf_event_open and are -1 where hardware counters are off limits.
+//
+//   classic_benchmark --processors=4 --tasks=64 --activations=1000000
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "cyber/scheduler/policy/classic_context.h"
+#include "cyber/scheduler/processor.h"
+
+DEFINE_int32(processors, 4, "processors of the group");
+DEFINE_int32(producers, 2, "threads waking tasks");
+DEFINE_int32(tasks, 64, "tasks of the group");
+DEFINE_int32(task_buffer_kb, 32, "memory every task touches when it runs");
+DEFINE_int64(activations, 1000000, "task activations per case");
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::croutine::RoutineState;
+
+namespace {
+
+class CacheMissCounter {
+ public:
+  // inherited by the threads created after it
+  CacheMissCounter() {
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = static_cast<int>(
+        syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    if (fd_ >= 0) {
+      ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+
+  ~CacheMissCounter() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  // only complete once the threads counted have exited
+  int64_t Read() {
+    if (fd_ < 0) {
+      return -1;
+    }
+    ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+    int64_t count = 0;
+    if (read(fd_, &count, sizeof(count)) != sizeof(count)) {
+      return -1;
+    }
+    return count;
+  }
+
+ private:
+  int fd_ = -1;
+};
+
+void Run(const std::string& group_name, bool work_stealing) {
+  CacheMissCounter cache_misses;
+
+  std::atomic<int64_t> activations = {0};
+  std::vector<std::shared_ptr<CRoutine>> tasks;
+  std::vector<std::vector<uint64_t>> buffers(FLAGS_tasks);
+  for (int i = 0; i < FLAGS_tasks; ++i) {
+    buffers[i].resize(FLAGS_task_buffer_kb * 1024 / sizeof(uint64_t), i);
+    auto buffer = &buffers[i];
+    auto cr = CRoutine::CreateStackless([buffer, &activations]() {
+      uint64_t sum = 0;
+      for (auto value : *buffer) {
+        sum += value;
+      }
+      (*buffer)[0] = sum;
+      activations.fetch_add(1, std::memory_order_relaxed);
+      return RoutineState::DATA_WAIT;
+    });
+    cr->set_id(i);
+    cr->set_group_name(group_name);
+    tasks.emplace_back(cr);
+  }
+
+  std::vector<std::shared_ptr<ClassicContext>> contexts;
+  std::vector<std::shared_ptr<Processor>> processors;
+  for (int i = 0; i < FLAGS_processors; ++i) {
+    auto ctx = std::make_shared<ClassicContext>(group_name, work_stealing);
+    auto processor = std::make_shared<Processor>();
+    processor->BindContext(ctx);
+    contexts.emplace_back(ctx);
+    processors.emplace_back(processor);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> producers;
+  for (int p = 0; p < FLAGS_producers; ++p) {
+    producers.emplace_back([&tasks, &activations, p]() {
+      std::mt19937 random(p);
+      std::uniform_int_distribution<size_t> pick(0, tasks.size() - 1);
+      while (activations.load(std::memory_order_relaxed) <
+             FLAGS_activations) {
+        auto& cr = tasks[pick(random)];
+        if (cr->state() == RoutineState::DATA_WAIT) {
+          cr->SetUpdateFlag();
+        }
+        ClassicContext::Enqueue(cr);
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+  for (auto& processor : processors) {
+    processor->Stop();
+  }
+
+  auto count = activations.load();
+  printf(
+      "{\"work_stealing\": %s, \"processors\": %d, \"tasks\": %d, "
+      "\"activations\": %lld, \"activations_per_sec\": %.0f, "
+      "\"cache_misses\": %lld}\n",
+      work_stealing ? "true" : "false", FLAGS_processors, FLAGS_tasks,
+      static_cast<long long>(count),
+      static_cast<double>(count) * 1e9 / static_cast<double>(ns),
+      static_cast<long long>(cache_misses.Read()));
+}
+
+}  // namespace
+
+void RunAll() {
+  // separate groups, no queue is shared between the cases
+  Run("benchmark_shared", false);
+  Run("benchmark_stealing", true);
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  apollo::cyber::scheduler::RunAll();
+  return 0;
+}
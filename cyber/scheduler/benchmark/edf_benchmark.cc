@@ -0,0 +1,242 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Deadline misses of a perception like DAG under the classic and the edf
+// policy. A source releases a frame every --frame_period_us, it passes a
+// chain of --stages tasks and is due --frame_period_us after its release.
+// Meanwhile --background tasks of --background_work_us each are woken every
+// millisecond with a relaxed deadline of one second, enough to keep all
+// processors busy. Under edf every stage is woken due at its frame's
+// deadline, classic runs both kinds at the same priority. One JSON object
+// per policy on stdout.
+//
+//   edf_benchmark --processors=2 --stages=4 --stage_work_us=1000
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "cyber/scheduler/policy/classic_context.h"
+#include "cyber/scheduler/policy/edf_context.h"
+#include "cyber/scheduler/processor.h"
+
+DEFINE_int32(processors, 2, "processors of the policy");
+DEFINE_int32(stages, 4, "tasks a frame passes one after the other");
+DEFINE_int32(stage_work_us, 1000, "cpu time of a stage per frame");
+DEFINE_int32(frame_period_us, 10000, "frame period, also its deadline");
+DEFINE_int32(background, 8, "background tasks");
+DEFINE_int32(background_work_us, 2000, "cpu time of a background run");
+DEFINE_int32(seconds, 3, "run time per policy");
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::croutine::RoutineState;
+using apollo::cyber::croutine::StepFunc;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// wakes task |index| due at |deadline|
+using WakeFunc = std::function<void(size_t index, Clock::time_point)>;
+
+void Spin(int us) {
+  auto end = Clock::now() + std::chrono::microseconds(us);
+  while (Clock::now() < end) {
+  }
+}
+
+int64_t ToNs(const Clock::time_point& time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             time.time_since_epoch())
+      .count();
+}
+
+struct Results {
+  std::atomic<uint64_t> frames = {0};
+  std::atomic<uint64_t> misses = {0};
+  std::atomic<int64_t> max_lateness_ns = {0};
+  std::atomic<uint64_t> background_runs = {0};
+};
+
+// Tasks 0 to stages - 1 are the chain, the rest background. Each stage
+// hands the deadline of the frame it processed on to the next.
+std::vector<StepFunc> MakeSteps(Results* results, const WakeFunc* wake,
+                                std::vector<std::atomic<int64_t>>* frames) {
+  std::vector<StepFunc> steps;
+  for (int i = 0; i < FLAGS_stages; ++i) {
+    steps.emplace_back([i, results, wake, frames]() {
+      auto deadline_ns = (*frames)[i].load();
+      Spin(FLAGS_stage_work_us);
+      if (i + 1 < FLAGS_stages) {
+        (*frames)[i + 1].store(deadline_ns);
+        Clock::time_point deadline{std::chrono::nanoseconds(deadline_ns)};
+        (*wake)(i + 1, deadline);
+        return RoutineState::DATA_WAIT;
+      }
+      results->frames++;
+      auto lateness = ToNs(Clock::now()) - deadline_ns;
+      if (lateness > 0) {
+        results->misses++;
+        auto max = results->max_lateness_ns.load();
+        while (lateness > max &&
+               !results->max_lateness_ns.compare_exchange_weak(max, lateness)) {
+        }
+      }
+      return RoutineState::DATA_WAIT;
+    });
+  }
+  for (int i = 0; i < FLAGS_background; ++i) {
+    steps.emplace_back([results]() {
+      Spin(FLAGS_background_work_us);
+      results->background_runs++;
+      return RoutineState::DATA_WAIT;
+    });
+  }
+  return steps;
+}
+
+// Releases frames and background work for --seconds, then stops
+// |processors|.
+void Drive(const WakeFunc& wake, std::vector<std::atomic<int64_t>>* frames,
+           std::vector<std::shared_ptr<Processor>>* processors) {
+  auto start = Clock::now();
+  auto end = start + std::chrono::seconds(FLAGS_seconds);
+  auto period = std::chrono::microseconds(FLAGS_frame_period_us);
+  std::thread source([&]() {
+    for (auto release = start; release < end; release += period) {
+      std::this_thread::sleep_until(release);
+      (*frames)[0].store(ToNs(release + period));
+      wake(0, release + period);
+    }
+  });
+  std::thread feeder([&]() {
+    while (Clock::now() < end) {
+      for (int i = 0; i < FLAGS_background; ++i) {
+        wake(FLAGS_stages + i, Clock::now() + std::chrono::seconds(1));
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  source.join();
+  feeder.join();
+  for (auto& processor : *processors) {
+    processor->Stop();
+  }
+}
+
+void Print(const std::string& policy, const Results& results) {
+  printf(
+      "{\"policy\": \"%s\", \"frames\": %llu, "
+      "\"frame_deadline_misses\": %llu, \"max_lateness_us\": %lld, "
+      "\"background_runs\": %llu}\n",
+      policy.c_str(), static_cast<unsigned long long>(results.frames.load()),
+      static_cast<unsigned long long>(results.misses.load()),
+      static_cast<long long>(results.max_lateness_ns.load() / 1000),
+      static_cast<unsigned long long>(results.background_runs.load()));
+}
+
+void RunClassic() {
+  Results results;
+  std::vector<std::atomic<int64_t>> frames(FLAGS_stages);
+  std::vector<std::shared_ptr<CRoutine>> routines;
+  WakeFunc wake = [&routines](size_t index, Clock::time_point) {
+    auto& cr = routines[index];
+    cr->SetUpdateFlag();
+    ClassicContext::Enqueue(cr);
+  };
+  uint64_t id = 0;
+  for (auto& step : MakeSteps(&results, &wake, &frames)) {
+    auto cr = CRoutine::CreateStackless(step);
+    cr->set_id(id++);
+    cr->set_group_name("edf_benchmark");
+    // waits for its first wake
+    cr->set_state(RoutineState::DATA_WAIT);
+    routines.emplace_back(cr);
+  }
+
+  std::vector<std::shared_ptr<Processor>> processors;
+  std::vector<std::shared_ptr<ClassicContext>> contexts;
+  for (int i = 0; i < FLAGS_processors; ++i) {
+    auto ctx = std::make_shared<ClassicContext>("edf_benchmark");
+    auto processor = std::make_shared<Processor>();
+    processor->BindContext(ctx);
+    contexts.emplace_back(ctx);
+    processors.emplace_back(processor);
+  }
+  Drive(wake, &frames, &processors);
+  Print("classic", results);
+}
+
+void RunEdf() {
+  Results results;
+  std::vector<std::atomic<int64_t>> frames(FLAGS_stages);
+  std::vector<std::shared_ptr<EdfTask>> tasks;
+  auto run_queue = std::make_shared<EdfRunQueue>();
+  WakeFunc wake = [&tasks, &run_queue](size_t index,
+                                       Clock::time_point deadline) {
+    auto& task = tasks[index];
+    task->cr->SetUpdateFlag();
+    run_queue->Enqueue(task, deadline);
+  };
+  uint64_t id = 0;
+  for (auto& step : MakeSteps(&results, &wake, &frames)) {
+    auto cr = CRoutine::CreateStackless(step);
+    cr->set_state(RoutineState::DATA_WAIT);
+    std::chrono::microseconds relative_deadline(FLAGS_frame_period_us);
+    if (id++ >= static_cast<uint64_t>(FLAGS_stages)) {
+      relative_deadline = std::chrono::seconds(1);
+    }
+    cr->set_id(id);
+    tasks.emplace_back(std::make_shared<EdfTask>(cr, relative_deadline));
+  }
+
+  std::vector<std::shared_ptr<Processor>> processors;
+  for (int i = 0; i < FLAGS_processors; ++i) {
+    auto processor = std::make_shared<Processor>();
+    processor->BindContext(std::make_shared<EdfContext>(run_queue));
+    processors.emplace_back(processor);
+  }
+  Drive(wake, &frames, &processors);
+  Print("edf", results);
+}
+
+}  // namespace
+
+void RunAll() {
+  RunClassic();
+  RunEdf();
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  apollo::cyber::scheduler::RunAll();
+  return 0;
+}
@@ -0,0 +1,391 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// End-to-end latency, throughput and context switches of a synthetic task
+// graph, run through Scheduler::CreateTask and NotifyTask under the
+// scheduler of every conf in --confs, each in a process of its own.
+//
+// The graph has layers of tasks as given by --layers, the first layer are
+// sources released at --rates_hz. Every other task reads from --fan_in
+// tasks of the layer before and runs once all of them delivered, a depth
+// one queue per input that drops the older message. So the fan-out of a
+// layer is --fan_in times the width of the next layer over its own. A run
+// costs --cost_us of cpu time, give or take --cost_jitter_pct percent. The
+// graph, the costs and the release phases all come from --seed, a run with
+// the same flags and conf puts the same load on the scheduler.
+//
+// Tasks are named bench_<layer>_<index>, which confs can refer to. Tasks
+// nobody reads from are sinks, latency is from the release of the oldest
+// source frame a sink's input goes back to until the sink ran. Context
+// switches are those of the process' threads, croutine switches count
+// every resume of a task. One JSON object per conf on stdout.
+//
+// With CYBER_PATH pointing at cyber/, --confs defaulting to both confs:
+//
+//   sched_benchmark --layers=2,4,4,1 --seconds=5
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "cyber/common/global_data.h"
+#include "cyber/croutine/croutine.h"
+#include "cyber/scheduler/scheduler_factory.h"
+
+DEFINE_string(confs, "sched_benchmark_classic,sched_benchmark_choreography",
+              "process groups to run under, by their conf/<name>.conf");
+DEFINE_string(layers, "2,4,4,1", "tasks per layer, sources first");
+DEFINE_int32(fan_in, 2, "inputs of every task but the sources");
+DEFINE_string(rates_hz, "100", "source rates, given to sources in turn");
+DEFINE_int32(cost_us, 200, "mean cpu time of a run");
+DEFINE_int32(cost_jitter_pct, 50, "spread of the cpu time of a run");
+DEFINE_int64(seed, 1, "seed of the graph, the costs and the phases");
+DEFINE_int32(warmup_ms, 500, "run time before measuring");
+DEFINE_int32(seconds, 5, "measured run time per conf");
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::common::GlobalData;
+using apollo::cyber::croutine::CRoutine;
+using apollo::cyber::croutine::RoutineState;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             Clock::now().time_since_epoch())
+      .count();
+}
+
+void Spin(int64_t ns) {
+  auto end = NowNs() + ns;
+  while (NowNs() < end) {
+  }
+}
+
+std::vector<std::string> Split(const std::string& str) {
+  std::vector<std::string> items;
+  std::stringstream ss(str);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+struct Task;
+
+struct Output {
+  Task* task;
+  size_t input;
+};
+
+struct Task {
+  std::string name;
+  uint64_t id = 0;
+  // release time of an undelivered message per input, 0 for none
+  std::vector<std::atomic<int64_t>> inputs;
+  std::vector<Output> outputs;
+  // of a source, the driver releases it
+  int64_t period_ns = 0;
+  int64_t phase_ns = 0;
+  // draws the cost of every run, only the task touches it
+  std::mt19937_64 rng;
+  std::uniform_int_distribution<int64_t> cost_ns;
+  // of a sink, written by the task only, read once it stopped
+  std::vector<int64_t> latencies_ns;
+
+  explicit Task(size_t num_inputs) : inputs(num_inputs) {}
+};
+
+struct Graph {
+  std::vector<std::unique_ptr<Task>> tasks;
+  size_t edges = 0;
+  std::atomic<uint64_t> drops = {0};
+  // messages released in between are measured
+  std::atomic<int64_t> window_start_ns = {0};
+  std::atomic<int64_t> window_end_ns = {std::numeric_limits<int64_t>::max()};
+};
+
+// Lays out the graph, it is the same for the same flags.
+bool Build(Graph* graph) {
+  std::vector<int> widths;
+  for (auto& width : Split(FLAGS_layers)) {
+    widths.push_back(std::stoi(width));
+  }
+  std::vector<int64_t> periods_ns;
+  for (auto& rate : Split(FLAGS_rates_hz)) {
+    periods_ns.push_back(static_cast<int64_t>(1e9 / std::stod(rate)));
+  }
+  if (widths.empty() || periods_ns.empty() || FLAGS_fan_in < 1 ||
+      *std::min_element(widths.begin(), widths.end()) < 1) {
+    fprintf(stderr, "bad --layers, --rates_hz or --fan_in\n");
+    return false;
+  }
+
+  std::mt19937_64 rng(FLAGS_seed);
+  int64_t cost_ns = FLAGS_cost_us * 1000;
+  int64_t jitter_ns = cost_ns * FLAGS_cost_jitter_pct / 100;
+  std::vector<Task*> previous;
+  for (size_t layer = 0; layer < widths.size(); ++layer) {
+    std::vector<Task*> current;
+    for (int i = 0; i < widths[layer]; ++i) {
+      size_t num_inputs =
+          layer == 0 ? 1
+                     : std::min<size_t>(FLAGS_fan_in, previous.size());
+      graph->tasks.emplace_back(new Task(num_inputs));
+      auto task = graph->tasks.back().get();
+      task->name = "bench_" + std::to_string(layer) + "_" + std::to_string(i);
+      task->rng.seed(rng());
+      task->cost_ns = std::uniform_int_distribution<int64_t>(
+          std::max<int64_t>(0, cost_ns - jitter_ns), cost_ns + jitter_ns);
+      if (layer == 0) {
+        task->period_ns = periods_ns[i % periods_ns.size()];
+        task->phase_ns = std::uniform_int_distribution<int64_t>(
+            0, task->period_ns - 1)(rng);
+      } else {
+        // inputs from the ones feeding fewest so far, at random among equals
+        auto candidates = previous;
+        std::shuffle(candidates.begin(), candidates.end(), rng);
+        std::stable_sort(candidates.begin(), candidates.end(),
+                         [](const Task* a, const Task* b) {
+                           return a->outputs.size() < b->outputs.size();
+                         });
+        for (size_t k = 0; k < num_inputs; ++k) {
+          candidates[k]->outputs.push_back({task, k});
+          ++graph->edges;
+        }
+      }
+      current.push_back(task);
+    }
+    previous = current;
+  }
+  return true;
+}
+
+// body of the croutine of |task|
+void Run(Graph* graph, Task* task, Scheduler* sched) {
+  for (;;) {
+    bool ready = true;
+    for (auto& input : task->inputs) {
+      ready = ready && input.load() != 0;
+    }
+    if (!ready) {
+      CRoutine::Yield(RoutineState::DATA_WAIT);
+      continue;
+    }
+
+    int64_t release_ns = std::numeric_limits<int64_t>::max();
+    for (auto& input : task->inputs) {
+      release_ns = std::min(release_ns, input.exchange(0));
+    }
+    Spin(task->cost_ns(task->rng));
+
+    if (task->outputs.empty() && release_ns >= graph->window_start_ns &&
+        release_ns < graph->window_end_ns) {
+      task->latencies_ns.push_back(NowNs() - release_ns);
+    }
+    for (auto& output : task->outputs) {
+      if (output.task->inputs[output.input].exchange(release_ns) != 0) {
+        ++graph->drops;
+      }
+      sched->NotifyTask(output.task->id);
+    }
+  }
+}
+
+// Releases the sources on their period until |end|.
+void Drive(Graph* graph, Scheduler* sched, const Clock::time_point& start,
+           const Clock::time_point& end) {
+  std::vector<Task*> sources;
+  std::vector<Clock::time_point> releases;
+  for (auto& task : graph->tasks) {
+    if (task->period_ns > 0) {
+      sources.push_back(task.get());
+      releases.push_back(start + std::chrono::nanoseconds(task->phase_ns));
+    }
+  }
+  for (;;) {
+    auto next = std::min_element(releases.begin(), releases.end());
+    if (*next >= end) {
+      return;
+    }
+    std::this_thread::sleep_until(*next);
+    auto source = sources[next - releases.begin()];
+    int64_t release_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            next->time_since_epoch())
+            .count();
+    if (source->inputs[0].exchange(release_ns) != 0) {
+      ++graph->drops;
+    }
+    sched->NotifyTask(source->id);
+    *next += std::chrono::nanoseconds(source->period_ns);
+  }
+}
+
+uint64_t ContextSwitches() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+uint64_t Activations(Scheduler* sched) {
+  uint64_t activations = 0;
+  for (auto& stats : sched->GetRoutineStats()) {
+    if (stats.first.compare(0, 6, "bench_") == 0) {
+      activations += stats.second.activations;
+    }
+  }
+  return activations;
+}
+
+int64_t Percentile(const std::vector<int64_t>& sorted, double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  auto index = static_cast<size_t>(
+      p * static_cast<double>(sorted.size() - 1) + 0.5);
+  return sorted[index];
+}
+
+// Runs the graph under the scheduler of |process_group|.
+int RunConf(const std::string& process_group) {
+  Graph graph;
+  if (!Build(&graph)) {
+    return 1;
+  }
+  GlobalData::Instance()->SetProcessGroup(process_group);
+  auto sched = Instance();
+  // all ids are known before any task can send
+  for (auto& task : graph.tasks) {
+    task->id = GlobalData::RegisterTaskName(task->name);
+  }
+  for (auto& task : graph.tasks) {
+    auto raw = task.get();
+    if (!sched->CreateTask([&graph, raw, sched]() { Run(&graph, raw, sched); },
+                           task->name)) {
+      fprintf(stderr, "cannot create task %s\n", task->name.c_str());
+      return 1;
+    }
+  }
+
+  auto start = Clock::now();
+  auto window_start = start + std::chrono::milliseconds(FLAGS_warmup_ms);
+  auto window = std::chrono::seconds(FLAGS_seconds);
+  auto end = window_start + window;
+  auto to_ns = [](const Clock::time_point& time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               time.time_since_epoch())
+        .count();
+  };
+  graph.window_start_ns = to_ns(window_start);
+  graph.window_end_ns = to_ns(end);
+
+  uint64_t switches = 0;
+  uint64_t activations = 0;
+  std::thread sampler([&]() {
+    std::this_thread::sleep_until(window_start);
+    switches = ContextSwitches();
+    activations = Activations(sched);
+    std::this_thread::sleep_until(end);
+    switches = ContextSwitches() - switches;
+    activations = Activations(sched) - activations;
+  });
+  Drive(&graph, sched, start, end);
+  sampler.join();
+  // lets the last frames through
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  sched->Shutdown();
+
+  std::vector<int64_t> latencies;
+  for (auto& task : graph.tasks) {
+    latencies.insert(latencies.end(), task->latencies_ns.begin(),
+                     task->latencies_ns.end());
+  }
+  std::sort(latencies.begin(), latencies.end());
+  double seconds = std::chrono::duration<double>(window).count();
+  printf(
+      "{\"conf\": \"%s\", \"seed\": %lld, \"tasks\": %zu, \"edges\": %zu, "
+      "\"frames\": %zu, \"throughput_hz\": %.1f, \"dropped\": %llu, "
+      "\"latency_us\": {\"p50\": %lld, \"p90\": %lld, \"p99\": %lld, "
+      "\"p999\": %lld, \"max\": %lld}, \"croutine_switches_per_s\": %.1f, "
+      "\"context_switches_per_s\": %.1f}\n",
+      process_group.c_str(), static_cast<long long>(FLAGS_seed),
+      graph.tasks.size(), graph.edges, latencies.size(),
+      static_cast<double>(latencies.size()) / seconds,
+      static_cast<unsigned long long>(graph.drops.load()),
+      static_cast<long long>(Percentile(latencies, 0.5) / 1000),
+      static_cast<long long>(Percentile(latencies, 0.9) / 1000),
+      static_cast<long long>(Percentile(latencies, 0.99) / 1000),
+      static_cast<long long>(Percentile(latencies, 0.999) / 1000),
+      static_cast<long long>(latencies.empty() ? 0 : latencies.back() / 1000),
+      static_cast<double>(activations) / seconds,
+      static_cast<double>(switches) / seconds);
+  fflush(stdout);
+  return 0;
+}
+
+}  // namespace
+
+// Every conf gets a fresh process, the scheduler is one per process.
+int RunAll() {
+  int failed = 0;
+  for (auto& conf : Split(FLAGS_confs)) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+      // processors never return, leave without tearing them down
+      _exit(RunConf(conf));
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0) {
+      fprintf(stderr, "conf %s failed\n", conf.c_str());
+      ++failed;
+    }
+  }
+  return failed == 0 ? 0 : 1;
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  return apollo::cyber::scheduler::RunAll();
+}
@@ -0,0 +1,226 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/cpu_topology.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <sstream>
+#include <tuple>
+#include <utility>
+
+#include "cyber/common/file.h"
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::common::DirectoryExists;
+using apollo::cyber::common::GetContent;
+
+namespace {
+
+bool ReadInt(const std::string& path, int64_t* value) {
+  std::string content;
+  if (!GetContent(path, &content) || content.empty()) {
+    return false;
+  }
+  char* end = nullptr;
+  *value = std::strtoll(content.c_str(), &end, 10);
+  return end != content.c_str();
+}
+
+// "0-3,8,10-11" as sysfs writes cpu lists
+std::vector<int> ReadCpuList(const std::string& path) {
+  std::vector<int> cpus;
+  std::string content;
+  if (!GetContent(path, &content)) {
+    return cpus;
+  }
+  std::stringstream ss(content);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    char* end = nullptr;
+    int first = static_cast<int>(std::strtol(range.c_str(), &end, 10));
+    if (end == range.c_str()) {
+      continue;
+    }
+    int last = first;
+    if (*end == '-') {
+      last = static_cast<int>(std::strtol(end + 1, nullptr, 10));
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+// first cpu sharing the last level data cache of |dir|, -1 if unknown
+int LastLevelCache(const std::string& dir) {
+  int64_t best_level = -1;
+  int first = -1;
+  for (int i = 0;; ++i) {
+    std::string index = dir + "/cache/index" + std::to_string(i);
+    if (!DirectoryExists(index)) {
+      break;
+    }
+    std::string type;
+    int64_t level = 0;
+    if (GetContent(index + "/type", &type) &&
+        type.compare(0, 11, "Instruction") == 0) {
+      continue;
+    }
+    if (!ReadInt(index + "/level", &level) || level < best_level) {
+      continue;
+    }
+    auto shared = ReadCpuList(index + "/shared_cpu_list");
+    if (!shared.empty()) {
+      best_level = level;
+      first = *std::min_element(shared.begin(), shared.end());
+    }
+  }
+  return first;
+}
+
+}  // namespace
+
+CpuTopology CpuTopology::Read(const std::string& root) {
+  CpuTopology topology;
+  std::map<std::pair<int64_t, int64_t>, int> cores;
+  std::map<std::pair<int64_t, int64_t>, int> clusters;
+  for (int cpu : ReadCpuList(root + "/online")) {
+    std::string dir = root + "/cpu" + std::to_string(cpu);
+    int64_t package = 0;
+    int64_t core = cpu;
+    ReadInt(dir + "/topology/physical_package_id", &package);
+    ReadInt(dir + "/topology/core_id", &core);
+
+    int64_t capacity = 0;
+    if (!ReadInt(dir + "/cpu_capacity", &capacity)) {
+      ReadInt(dir + "/cpufreq/cpuinfo_max_freq", &capacity);
+    }
+    // cpus of a package share a cache at least
+    int64_t cache = LastLevelCache(dir);
+    if (cache < 0) {
+      cache = -1 - package;
+    }
+
+    CpuInfo info;
+    info.cpu = cpu;
+    info.core = cores.emplace(std::make_pair(package, core), cores.size())
+                    .first->second;
+    info.cluster =
+        clusters.emplace(std::make_pair(cache, capacity), clusters.size())
+            .first->second;
+    info.capacity = static_cast<uint32_t>(capacity);
+    topology.Add(info);
+  }
+  return topology;
+}
+
+std::string CpuTopology::DebugString() const {
+  std::map<int, std::map<int, std::vector<int>>> clusters;
+  std::map<int, uint32_t> capacities;
+  for (auto& info : cpus_) {
+    clusters[info.cluster][info.core].push_back(info.cpu);
+    capacities[info.cluster] = info.capacity;
+  }
+  std::stringstream ss;
+  for (auto& cluster : clusters) {
+    ss << "cluster " << cluster.first << " capacity "
+       << capacities[cluster.first] << " cores";
+    for (auto& core : cluster.second) {
+      ss << " [";
+      for (size_t i = 0; i < core.second.size(); ++i) {
+        ss << (i ? " " : "") << core.second[i];
+      }
+      ss << "]";
+    }
+    ss << "\n";
+  }
+  return ss.str();
+}
+
+CpuPlacer::CpuPlacer(const CpuTopology& topology) : topology_(topology) {
+  int cpus = 0;
+  int cores = 0;
+  for (auto& info : topology_.cpus()) {
+    cpus = std::max(cpus, info.cpu + 1);
+    cores = std::max(cores, info.core + 1);
+  }
+  cpu_load_.resize(cpus, 0);
+  core_load_.resize(cores, 0);
+  AINFO << "cpu topology:\n" << topology_.DebugString();
+}
+
+std::vector<int> CpuPlacer::Place(const std::string& name, uint32_t num,
+                                  const std::vector<int>& allowed) {
+  std::vector<const CpuInfo*> candidates;
+  for (auto& info : topology_.cpus()) {
+    if (allowed.empty() || std::find(allowed.begin(), allowed.end(),
+                                     info.cpu) != allowed.end()) {
+      candidates.push_back(&info);
+    }
+  }
+  std::vector<int> cpus;
+  if (candidates.empty()) {
+    AWARN << "no known cpu to place the processors of " << name
+          << " on, they are not pinned.";
+    return cpus;
+  }
+
+  std::set<int> clusters;
+  for (uint32_t i = 0; i < num; ++i) {
+    std::map<int, std::set<int>> free_cores;
+    for (auto info : candidates) {
+      if (core_load_[info->core] == 0) {
+        free_cores[info->cluster].insert(info->core);
+      }
+    }
+    // a core of its own first, then the clusters the group is in already,
+    // then the fastest and the emptiest cluster, a cpu of its own last
+    auto key = [&](const CpuInfo* info) {
+      int free = static_cast<int>(free_cores[info->cluster].size());
+      return std::make_tuple(core_load_[info->core],
+                             clusters.count(info->cluster) == 0,
+                             -static_cast<int64_t>(info->capacity), -free,
+                             cpu_load_[info->cpu], info->cpu);
+    };
+    auto best = *std::min_element(
+        candidates.begin(), candidates.end(),
+        [&key](const CpuInfo* a, const CpuInfo* b) { return key(a) < key(b); });
+    ++cpu_load_[best->cpu];
+    ++core_load_[best->core];
+    clusters.insert(best->cluster);
+    cpus.push_back(best->cpu);
+  }
+
+  std::stringstream ss;
+  for (size_t i = 0; i < cpus.size(); ++i) {
+    ss << (i ? " " : "") << cpus[i];
+  }
+  AINFO << "auto affinity of " << name << ": processors on cpus [" << ss.str()
+        << "] in " << clusters.size() << " cluster(s)";
+  return cpus;
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,82 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_CPU_TOPOLOGY_H_
+#define CYBER_SCHEDULER_CPU_TOPOLOGY_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+// One online cpu. Cpus of a core are SMT siblings, cpus of a cluster share
+// their last level cache and run at the same capacity, so a big.LITTLE
+// board has a cluster per kind of core even under a common cache.
+struct CpuInfo {
+  int cpu = 0;
+  int core = 0;
+  int cluster = 0;
+  // cpu_capacity or the maximum frequency in kHz, 0 if unknown
+  uint32_t capacity = 0;
+};
+
+class CpuTopology {
+ public:
+  static constexpr const char* kSysfsRoot = "/sys/devices/system/cpu";
+
+  // The online cpus as described under |root|, empty if it cannot be read.
+  static CpuTopology Read(const std::string& root = kSysfsRoot);
+
+  void Add(const CpuInfo& info) { cpus_.push_back(info); }
+  const std::vector<CpuInfo>& cpus() const { return cpus_; }
+  bool empty() const { return cpus_.empty(); }
+
+  // one line per cluster, its cpus by core and its capacity
+  std::string DebugString() const;
+
+ private:
+  std::vector<CpuInfo> cpus_;
+};
+
+// Hands out the cpus of a topology to processors for affinity "auto". The
+// processors of one group, which run tasks that talk to each other, stay in
+// one cluster as long as it has cores left, and get a core each before any
+// two of them share one, across all groups placed. A group starts in the
+// fastest cluster with unused cores, the one with most of them on a tie.
+class CpuPlacer {
+ public:
+  explicit CpuPlacer(const CpuTopology& topology);
+
+  // One cpu for each of |num| processors of |name|, out of |allowed| or
+  // out of all cpus if that is empty. Empty if none of them is known.
+  std::vector<int> Place(const std::string& name, uint32_t num,
+                         const std::vector<int>& allowed);
+
+ private:
+  CpuTopology topology_;
+  // processors placed so far
+  std::vector<int> cpu_load_;
+  std::vector<int> core_load_;
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_CPU_TOPOLOGY_H_
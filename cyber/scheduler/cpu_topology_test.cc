@@ -0,0 +1,118 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/cpu_topology.h"
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "cyber/common/file.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::common::EnsureDirectory;
+using apollo::cyber::common::RemoveAllFiles;
+
+void WriteFile(const std::string& path, const std::string& content) {
+  EnsureDirectory(path.substr(0, path.rfind('/')));
+  std::ofstream(path) << content << "\n";
+}
+
+CpuInfo Cpu(int cpu, int core, int cluster, uint32_t capacity) {
+  CpuInfo info;
+  info.cpu = cpu;
+  info.core = core;
+  info.cluster = cluster;
+  info.capacity = capacity;
+  return info;
+}
+
+TEST(CpuTopologyTest, read) {
+  char dir[] = "/tmp/cpu_topology_test.XXXXXX";
+  ASSERT_NE(nullptr, mkdtemp(dir));
+  std::string root(dir);
+
+  // 4 cores with 2 threads each, in 2 clusters of 2 cores, cpu 7 offline
+  WriteFile(root + "/online", "0-6");
+  for (int cpu = 0; cpu < 8; ++cpu) {
+    std::string path = root + "/cpu" + std::to_string(cpu);
+    int core = cpu % 4;
+    WriteFile(path + "/topology/physical_package_id", "0");
+    WriteFile(path + "/topology/core_id", std::to_string(core));
+    WriteFile(path + "/cache/index0/level", "1");
+    WriteFile(path + "/cache/index0/type", "Instruction");
+    WriteFile(path + "/cache/index0/shared_cpu_list",
+              std::to_string(core) + "," + std::to_string(core + 4));
+    WriteFile(path + "/cache/index1/level", "3");
+    WriteFile(path + "/cache/index1/type", "Unified");
+    WriteFile(path + "/cache/index1/shared_cpu_list",
+              core < 2 ? "0-1,4-5" : "2-3,6-7");
+  }
+
+  auto topology = CpuTopology::Read(root);
+  auto& cpus = topology.cpus();
+  ASSERT_EQ(7, cpus.size());
+  EXPECT_EQ(cpus[0].core, cpus[4].core);
+  EXPECT_NE(cpus[0].core, cpus[1].core);
+  EXPECT_EQ(cpus[0].cluster, cpus[5].cluster);
+  EXPECT_NE(cpus[0].cluster, cpus[2].cluster);
+  EXPECT_EQ(cpus[2].cluster, cpus[6].cluster);
+  EXPECT_EQ(0, cpus[0].capacity);
+
+  // clusters of another capacity are apart under the same cache
+  WriteFile(root + "/cpu1/cpu_capacity", "1024");
+  topology = CpuTopology::Read(root);
+  EXPECT_NE(topology.cpus()[0].cluster, topology.cpus()[1].cluster);
+  EXPECT_EQ(1024, topology.cpus()[1].capacity);
+
+  EXPECT_TRUE(CpuTopology::Read(root + "/none").empty());
+  RemoveAllFiles(root);
+}
+
+TEST(CpuTopologyTest, place) {
+  // little cores 0-3, big cores 4-5
+  CpuTopology big_little;
+  for (int cpu = 0; cpu < 6; ++cpu) {
+    big_little.Add(Cpu(cpu, cpu, cpu < 4 ? 0 : 1, cpu < 4 ? 512 : 1024));
+  }
+  CpuPlacer placer(big_little);
+  EXPECT_EQ(std::vector<int>({4, 5}), placer.Place("a", 2, {}));
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), placer.Place("b", 3, {}));
+  // out of cores, doubles up in the cluster it is in
+  EXPECT_EQ(std::vector<int>({3, 0}), placer.Place("c", 2, {}));
+  EXPECT_EQ(std::vector<int>({1}), placer.Place("d", 1, {1}));
+  EXPECT_TRUE(placer.Place("e", 1, {42}).empty());
+
+  // a core each before SMT siblings
+  CpuTopology smt;
+  smt.Add(Cpu(0, 0, 0, 0));
+  smt.Add(Cpu(1, 1, 0, 0));
+  smt.Add(Cpu(2, 0, 0, 0));
+  smt.Add(Cpu(3, 1, 0, 0));
+  CpuPlacer smt_placer(smt);
+  EXPECT_EQ(std::vector<int>({0, 1, 2}), smt_placer.Place("a", 3, {}));
+  EXPECT_EQ(std::vector<int>({3}), smt_placer.Place("b", 1, {}));
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
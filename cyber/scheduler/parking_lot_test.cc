@@ -0,0 +1,184 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/parking_lot.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+void WaitIdle(const ParkingLot& lot, int slot) {
+  while (!lot.Idle(slot)) {
+    std::this_thread::yield();
+  }
+}
+
+TEST(ParkingLotTest, unpark) {
+  ParkingLot lot;
+  EXPECT_FALSE(lot.UnparkOne());
+
+  // work is there already, no parking
+  lot.Park(0, []() { return true; });
+  EXPECT_FALSE(lot.Idle(0));
+
+  // times out
+  auto start = ParkingLot::Clock::now();
+  lot.Park(0, []() { return false; },
+           start + std::chrono::milliseconds(10));
+  EXPECT_GE(ParkingLot::Clock::now() - start, std::chrono::milliseconds(10));
+  EXPECT_FALSE(lot.Idle(0));
+
+  std::atomic<int> woken = {-1};
+  std::vector<std::thread> threads;
+  for (int slot : {3, 70}) {
+    threads.emplace_back([&lot, &woken, slot]() {
+      lot.Park(slot, []() { return false; });
+      woken.store(slot);
+    });
+  }
+  WaitIdle(lot, 3);
+  WaitIdle(lot, 70);
+
+  // the preferred slot first, exactly one per call
+  EXPECT_TRUE(lot.UnparkOne(70));
+  threads[1].join();
+  EXPECT_EQ(70, woken.load());
+  EXPECT_TRUE(lot.Idle(3));
+  EXPECT_TRUE(lot.UnparkOne(70));
+  threads[0].join();
+  EXPECT_EQ(3, woken.load());
+  EXPECT_FALSE(lot.UnparkOne());
+}
+
+TEST(ParkingLotTest, spinning) {
+  ParkingLot lot;
+  std::atomic<bool> woken = {false};
+  std::thread thread([&]() {
+    lot.Park(3, []() { return false; });
+    woken.store(true);
+  });
+  WaitIdle(lot, 3);
+
+  // a spinning slot is claimed first and nobody is woken
+  lot.BeginSpin(5);
+  EXPECT_TRUE(lot.UnparkOne(3));
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_FALSE(woken.load());
+  EXPECT_TRUE(lot.Idle(3));
+
+  // claimed once only
+  EXPECT_TRUE(lot.UnparkOne());
+  thread.join();
+  EXPECT_TRUE(woken.load());
+  lot.EndSpin(5);
+  lot.BeginSpin(6);
+  lot.EndSpin(6);
+  EXPECT_FALSE(lot.UnparkOne());
+}
+
+void NoLostWakeup(bool spin) {
+  ParkingLot lot;
+  const int slots = 4;
+  const int items = 100000;
+  std::atomic<int> queued = {0};
+  std::atomic<int> taken = {0};
+  std::vector<std::thread> threads;
+  for (int slot = 0; slot < slots; ++slot) {
+    threads.emplace_back([&, slot]() {
+      auto take = [&]() {
+        int n = queued.load();
+        while (n > 0) {
+          if (queued.compare_exchange_weak(n, n - 1)) {
+            return true;
+          }
+        }
+        return false;
+      };
+      while (taken.load() < items) {
+        if (take()) {
+          taken.fetch_add(1);
+          continue;
+        }
+        if (spin) {
+          lot.BeginSpin(slot);
+          bool found = false;
+          for (int i = 0; i < 100 && !found; ++i) {
+            found = take();
+          }
+          lot.EndSpin(slot);
+          if (found) {
+            taken.fetch_add(1);
+            continue;
+          }
+        }
+        lot.Park(slot, [&]() {
+          return queued.load() > 0 || taken.load() >= items;
+        });
+      }
+      // whoever took the last one lets the others go
+      for (int i = 0; i < slots; ++i) {
+        lot.Unpark(i);
+      }
+    });
+  }
+  for (int i = 0; i < items; ++i) {
+    queued.fetch_add(1);
+    lot.UnparkOne(i % slots);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(items, taken.load());
+}
+
+TEST(ParkingLotTest, no_lost_wakeup) { NoLostWakeup(false); }
+
+TEST(ParkingLotTest, no_lost_wakeup_spinning) { NoLostWakeup(true); }
+
+TEST(ParkingLotTest, parker) {
+  Parker parker;
+  auto start = Parker::Clock::now();
+  parker.Park(start + std::chrono::milliseconds(10));
+  EXPECT_GE(Parker::Clock::now() - start, std::chrono::milliseconds(10));
+
+  // kept until the next park
+  parker.Unpark();
+  start = Parker::Clock::now();
+  parker.Park(start + std::chrono::seconds(10));
+  EXPECT_LT(Parker::Clock::now() - start, std::chrono::seconds(10));
+
+  std::atomic<bool> woken = {false};
+  std::thread thread([&]() {
+    parker.Park();
+    woken.store(true);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_FALSE(woken.load());
+  parker.Unpark();
+  thread.join();
+  EXPECT_TRUE(woken.load());
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
@@ -16,6 +16,9 @@
 
 #include "cyber/scheduler/policy/choreography_context.h"
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -39,6 +42,7 @@ std::shared_ptr<CRoutine> ChoreographyContext::NextRoutine() {
     return nullptr;
   }
 
+  next_wake_ = std::chrono::steady_clock::time_point::max();
   ReadLockGuard<AtomicRWLock> lock(rq_lk_);
   for (auto it = cr_queue_.begin(); it != cr_queue_.end();) {
     auto cr = it->second;
@@ -53,30 +57,38 @@ std::shared_ptr<CRoutine> ChoreographyContext::NextRoutine() {
       return cr;
     }
 
+    if (cr->state() == RoutineState::SLEEP) {
+      next_wake_ = std::min(next_wake_, cr->wake_time());
+    }
     cr->Release();
     ++it;
   }
 
-  notified_.clear();
   return nullptr;
 }
 
 bool ChoreographyContext::Enqueue(const std::shared_ptr<CRoutine>& cr) {
-  WriteLockGuard<AtomicRWLock> lock(rq_lk_);
-  cr_queue_.emplace(cr->priority(), cr);
+  {
+    WriteLockGuard<AtomicRWLock> lock(rq_lk_);
+    cr_queue_.emplace(cr->priority(), cr);
+  }
+  Notify();
   return true;
 }
 
-void ChoreographyContext::Notify() {
-  if (!notified_.test_and_set(std::memory_order_acquire)) {
-    cv_wq_.notify_one();
+void ChoreographyContext::Notify() { parker_.Unpark(); }
+
+void ChoreographyContext::Wait() {
+  if (stop_.load()) {
     return;
   }
+  // a Notify since NextRoutine looked makes this return at once
+  parker_.Park(next_wake_);
 }
 
-void ChoreographyContext::Wait() {
-  std::unique_lock<std::mutex> lk(mtx_wq_);
-  cv_wq_.wait_for(lk, std::chrono::milliseconds(1));
+void ChoreographyContext::Shutdown() {
+  ProcessorContext::Shutdown();
+  parker_.Unpark();
 }
 
 void ChoreographyContext::RemoveCRoutine(uint64_t crid) {
@@ -96,6 +108,22 @@ void ChoreographyContext::RemoveCRoutine(uint64_t crid) {
     ++it;
   }
 }
+
+std::shared_ptr<CRoutine> ChoreographyContext::TakeCRoutine(uint64_t crid) {
+  WriteLockGuard<AtomicRWLock> lock(rq_lk_);
+  for (auto it = cr_queue_.begin(); it != cr_queue_.end(); ++it) {
+    auto cr = it->second;
+    if (cr->id() == crid) {
+      while (!cr->Acquire()) {
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
+      }
+      cr_queue_.erase(it);
+      cr->Release();
+      return cr;
+    }
+  }
+  return nullptr;
+}
 }  // namespace scheduler
 }  // namespace cyber
 }  // namespace apollo
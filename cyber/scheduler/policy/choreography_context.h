@@ -17,6 +17,7 @@
 #ifndef CYBER_SCHEDULER_POLICY_CHOREOGRAPHY_CONTEXT_H_
 #define CYBER_SCHEDULER_POLICY_CHOREOGRAPHY_CONTEXT_H_
 
+#include <chrono>
 #include <functional>
 #include <map>
 #include <memory>
@@ -26,6 +27,7 @@
 
 #include "cyber/base/atomic_rw_lock.h"
 #include "cyber/croutine/croutine.h"
+#include "cyber/scheduler/policy/parking_lot.h"
 #include "cyber/scheduler/processor_context.h"
 
 namespace apollo {
@@ -35,18 +37,27 @@ namespace scheduler {
 using apollo::cyber::base::AtomicRWLock;
 using croutine::CRoutine;
 
+// Runs the routines pinned to one processor. The processor parks whenever
+// none of them is ready and is woken by Notify only, or when the earliest
+// sleeping routine is due, so it spends no time polling.
 class ChoreographyContext : public ProcessorContext {
  public:
   void RemoveCRoutine(uint64_t crid);
+  // Takes the routine off this processor once it is not running, nullptr
+  // if it is not here.
+  std::shared_ptr<CRoutine> TakeCRoutine(uint64_t crid);
   std::shared_ptr<CRoutine> NextRoutine() override;
 
   bool Enqueue(const std::shared_ptr<CRoutine>&);
   void Notify();
   void Wait() override;
+  void Shutdown() override;
 
  private:
-  std::mutex mtx_wq_;
-  std::condition_variable cv_wq_;
+  Parker parker_;
+  // wake time of the earliest sleeping routine, found by NextRoutine
+  std::chrono::steady_clock::time_point next_wake_ =
+      std::chrono::steady_clock::time_point::max();
 
   AtomicRWLock rq_lk_;
   std::multimap<uint32_t, std::shared_ptr<CRoutine>, std::greater<uint32_t>>
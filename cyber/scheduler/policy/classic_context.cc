@@ -15,35 +15,96 @@
  *****************************************************************************/
 
 #include "cyber/scheduler/policy/classic_context.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
 #include "cyber/event/perf_event_cache.h"
 
 namespace apollo {
 namespace cyber {
 namespace scheduler {
 
-using apollo::cyber::base::AtomicRWLock;
-using apollo::cyber::base::ReadLockGuard;
 using apollo::cyber::croutine::CRoutine;
 using apollo::cyber::croutine::RoutineState;
 using apollo::cyber::event::PerfEventCache;
 using apollo::cyber::event::SchedPerf;
 
-alignas(CACHELINE_SIZE) GRP_WQ_MUTEX ClassicContext::mtx_wq_;
-alignas(CACHELINE_SIZE) GRP_WQ_CV ClassicContext::cv_wq_;
 alignas(CACHELINE_SIZE) RQ_LOCK_GROUP ClassicContext::rq_locks_;
 alignas(CACHELINE_SIZE) CR_GROUP ClassicContext::cr_group_;
+alignas(CACHELINE_SIZE) CLASSIC_GROUP ClassicContext::groups_;
+std::mutex ClassicContext::groups_mutex_;
+
+namespace {
+
+bool HasQueued(const MULTI_PRIO_READY_QUEUE* queues) {
+  for (auto& queue : *queues) {
+    if (!queue.Empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+int LocalQueues::Acquire(bool local_queue) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int i = 0; i < MAX_GROUP_PROCESSORS; ++i) {
+    if (used_[i]) {
+      continue;
+    }
+    used_[i] = true;
+    if (local_queue && queues_[i].load(std::memory_order_relaxed) == nullptr) {
+      queues_[i].store(new MULTI_PRIO_READY_QUEUE(), std::memory_order_release);
+    }
+    if (i >= size_.load(std::memory_order_relaxed)) {
+      size_.store(i + 1, std::memory_order_release);
+    }
+    return i;
+  }
+  return -1;
+}
+
+void LocalQueues::Release(int index) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  used_[index] = false;
+}
 
-ClassicContext::ClassicContext() { InitGroup(DEFAULT_GROUP_NAME); }
+ClassicContext::ClassicContext() : ClassicContext(DEFAULT_GROUP_NAME, false) {}
 
-ClassicContext::ClassicContext(const std::string& group_name) {
+ClassicContext::ClassicContext(const std::string& group_name,
+                               bool work_stealing) {
   InitGroup(group_name);
+  slot_ = siblings_->Acquire(work_stealing);
+  if (slot_ < 0) {
+    AWARN << "group " << group_name << " has more than "
+          << MAX_GROUP_PROCESSORS
+          << " processors, the rest polls instead of parking.";
+  }
+  if (work_stealing) {
+    local_queue_ = siblings_->Get(slot_);
+  }
+}
+
+ClassicContext::~ClassicContext() {
+  if (slot_ >= 0) {
+    siblings_->Release(slot_);
+  }
 }
 
 void ClassicContext::InitGroup(const std::string& group_name) {
-  multi_pri_rq_ = &cr_group_[group_name];
-  lq_ = &rq_locks_[group_name];
-  mtx_ptr_ = &mtx_wq_[group_name];
-  cv_ptr_ = &cv_wq_[group_name];
+  cr_group_[group_name];
+  rq_locks_[group_name];
+  {
+    std::lock_guard<std::mutex> lock(groups_mutex_);
+    group_ = &groups_[group_name];
+  }
+  ready_queue_ = &group_->ready_queue;
+  siblings_ = &group_->local_queues;
 }
 
 std::shared_ptr<CRoutine> ClassicContext::NextRoutine() {
@@ -51,31 +112,160 @@ std::shared_ptr<CRoutine> ClassicContext::NextRoutine() {
     return nullptr;
   }
 
-  for (int i = MAX_PRIO - 1; i >= 0; --i) {
-    ReadLockGuard<AtomicRWLock> lk(lq_->at(i));
-    for (auto& cr : multi_pri_rq_->at(i)) {
-      if (!cr->Acquire()) {
-        continue;
-      }
+  if (current_ != nullptr) {
+    auto cr = std::move(current_);
+    current_ = nullptr;
+    Requeue(cr);
+  }
+
+  if (unlikely(!sleepers_.Empty())) {
+    WakeSleepers();
+  }
 
-      if (cr->UpdateState() == RoutineState::READY) {
-        PerfEventCache::Instance()->AddSchedEvent(SchedPerf::NEXT_RT, cr->id(),
-                                                  cr->processor_id());
-        return cr;
+  std::shared_ptr<CRoutine> cr;
+  while (Dequeue(&cr) || Steal(&cr)) {
+    // a queued routine runs nowhere else, only a requeue or a removal
+    // may hold it for a moment
+    while (!cr->Acquire()) {
+      cpu_relax();
+    }
+
+    if (cr->UpdateState() == RoutineState::READY) {
+      PerfEventCache::Instance()->AddSchedEvent(SchedPerf::NEXT_RT, cr->id(),
+                                                cr->processor_id());
+      cr->set_processor_slot(slot_);
+      current_ = cr;
+      // more than we can run right now, let a sibling steal the rest
+      if (local_queue_ != nullptr && HasQueued(local_queue_)) {
+        group_->parking_lot.UnparkOne();
       }
+      return cr;
+    }
+
+    cr->Release();
+    Requeue(cr);
+  }
+
+  return nullptr;
+}
+
+bool ClassicContext::Dequeue(std::shared_ptr<CRoutine>* cr) {
+  // Shared before local, routines requeued locally would starve the shared
+  // queue of the same priority otherwise. With local queues a routine only
+  // gets there before it ran first, so it cannot starve the local ones.
+  for (int i = MAX_PRIO - 1; i >= 0; --i) {
+    if (ready_queue_->at(i).Dequeue(cr)) {
+      return true;
+    }
+    if (local_queue_ != nullptr && local_queue_->at(i).Dequeue(cr)) {
+      return true;
+    }
+  }
+  return false;
+}
 
-      if (unlikely(cr->state() == RoutineState::SLEEP)) {
-        if (!need_sleep_ || wake_time_ > cr->wake_time()) {
-          need_sleep_ = true;
-          wake_time_ = cr->wake_time();
-        }
+bool ClassicContext::Steal(std::shared_ptr<CRoutine>* cr) {
+  if (local_queue_ == nullptr) {
+    return false;
+  }
+  // start next to us, so that siblings do not all rob the same one
+  int size = siblings_->size();
+  for (int k = 1; k < size; ++k) {
+    auto victim = siblings_->Get((slot_ + k) % size);
+    if (victim == nullptr) {
+      continue;
+    }
+    for (int i = MAX_PRIO - 1; i >= 0; --i) {
+      if (victim->at(i).Dequeue(cr)) {
+        return true;
       }
+    }
+  }
+  return false;
+}
+
+void ClassicContext::Requeue(const std::shared_ptr<CRoutine>& cr) {
+  while (!cr->Acquire()) {
+    cpu_relax();
+  }
+  auto state = cr->UpdateState();
+  cr->Release();
 
-      cr->Release();
+  if (unlikely(cr->migrating()) &&
+      (state == RoutineState::READY || state == RoutineState::SLEEP)) {
+    HandOver(cr);
+    return;
+  }
+
+  switch (state) {
+    case RoutineState::READY:
+      HomeQueue()->at(cr->priority()).Enqueue(cr);
+      return;
+    case RoutineState::SLEEP:
+      sleepers_.Push(cr->wake_time(), cr);
+      return;
+    case RoutineState::FINISHED:
+      // stays marked queued, nothing is going to run it again
+      return;
+    default:
+      break;
+  }
+
+  // Waiting for data, from now on a notification queues it. One that came
+  // in while it was still marked queued has only cleared its update flag.
+  cr->ClearQueued();
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (cr->Acquire()) {
+    if (cr->UpdateState() == RoutineState::READY && cr->MarkQueued()) {
+      HomeQueue()->at(cr->priority()).Enqueue(cr);
     }
+    cr->Release();
+  }
+}
+
+void ClassicContext::HandOver(const std::shared_ptr<CRoutine>& cr) {
+  cr->ClearQueued();
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  // the migration was cancelled meanwhile, it stays with us
+  if (!cr->migrating() && cr->MarkQueued()) {
+    HomeQueue()->at(cr->priority()).Enqueue(cr);
   }
+}
 
-  return nullptr;
+void ClassicContext::WakeSleepers() {
+  if (unlikely(group_->migrations.load(std::memory_order_acquire) > 0)) {
+    std::vector<std::shared_ptr<CRoutine>> migrating;
+    sleepers_.TakeIf(
+        [](const std::shared_ptr<CRoutine>& cr) { return cr->migrating(); },
+        &migrating);
+    for (auto& cr : migrating) {
+      HandOver(cr);
+    }
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  std::shared_ptr<CRoutine> cr;
+  while (sleepers_.PopDue(now, &cr)) {
+    HomeQueue()->at(cr->priority()).Enqueue(cr);
+  }
+}
+
+bool ClassicContext::HasReady() const {
+  if (HasQueued(ready_queue_)) {
+    return true;
+  }
+  if (local_queue_ == nullptr) {
+    return false;
+  }
+  // our own and whatever can be stolen
+  int size = siblings_->size();
+  for (int i = 0; i < size; ++i) {
+    auto queues = siblings_->Get(i);
+    if (queues != nullptr && HasQueued(queues)) {
+      return true;
+    }
+  }
+  return false;
 }
 
 void ClassicContext::Wait() {
@@ -83,23 +273,118 @@ void ClassicContext::Wait() {
     return;
   }
 
-  std::unique_lock<std::mutex> lk(*mtx_ptr_);
-  if (unlikely(need_sleep_)) {
-    auto duration = wake_time_ - std::chrono::steady_clock::now();
-    cv_ptr_->wait_for(lk, duration);
-    need_sleep_ = false;
-  } else {
-    cv_ptr_->wait(lk);
+  auto deadline = sleepers_.NextWake();
+
+  if (unlikely(slot_ < 0)) {
+    std::this_thread::sleep_until(
+        std::min(deadline, ParkingLot::Clock::now() +
+                               std::chrono::milliseconds(1)));
+    return;
+  }
+
+  group_->parking_lot.Park(
+      slot_, [this]() { return stop_.load() || HasReady(); }, deadline);
+}
+
+void ClassicContext::BeginSpin() {
+  if (slot_ >= 0) {
+    group_->parking_lot.BeginSpin(slot_);
+  }
+}
+
+void ClassicContext::EndSpin() {
+  if (slot_ >= 0) {
+    group_->parking_lot.EndSpin(slot_);
   }
 }
 
 void ClassicContext::Shutdown() {
   stop_.exchange(true);
-  cv_ptr_->notify_all();
+  if (slot_ >= 0) {
+    group_->parking_lot.Unpark(slot_);
+  }
 }
 
-void ClassicContext::Notify(const std::string& group_name) {
-  cv_wq_[group_name].notify_one();
+void ClassicContext::Enqueue(const std::shared_ptr<CRoutine>& cr) {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!cr->MarkQueued()) {
+    return;
+  }
+  auto group = GroupOf(cr);
+  if (unlikely(group == nullptr)) {
+    AERROR << "routine " << cr->name() << " not queued, group "
+           << cr->group_name() << " has no processors.";
+    cr->ClearQueued();
+    return;
+  }
+  int slot = cr->processor_slot();
+  auto queues = group->local_queues.Get(slot);
+  if (queues == nullptr) {
+    queues = &group->ready_queue;
+  }
+  queues->at(cr->priority()).Enqueue(cr);
+  group->parking_lot.UnparkOne(slot);
+}
+
+ClassicGroup* ClassicContext::FindGroup(const std::string& group_name) {
+  std::lock_guard<std::mutex> lock(groups_mutex_);
+  auto iter = groups_.find(group_name);
+  return iter == groups_.end() ? nullptr : &iter->second;
+}
+
+ClassicGroup* ClassicContext::GroupOf(const std::shared_ptr<CRoutine>& cr) {
+  auto group = cr->group();
+  if (likely(group != nullptr)) {
+    return group;
+  }
+  // map nodes never move, the pointer stays valid
+  group = FindGroup(cr->group_name());
+  cr->set_group(group);
+  return group;
+}
+
+bool ClassicContext::Migrate(const std::shared_ptr<CRoutine>& cr,
+                             const std::string& group_name,
+                             const std::function<bool()>& cancel) {
+  auto to = FindGroup(group_name);
+  auto from = GroupOf(cr);
+  if (to == nullptr || from == nullptr) {
+    AERROR << "cannot migrate " << cr->name() << " from group "
+           << cr->group_name() << " to " << group_name
+           << ", both need processors.";
+    return false;
+  }
+  cr->set_migrating(true);
+  from->migrations.fetch_add(1);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  // Holding it queued makes it ours, nobody else reads its group then. A
+  // waiting routine is free at once, a queued or running one is let go by
+  // the processor that requeues it, a sleeping one by WakeSleepers.
+  while (!cr->MarkQueued()) {
+    if (cancel() || cr->state() == RoutineState::FINISHED) {
+      cr->set_migrating(false);
+      from->migrations.fetch_sub(1);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      // let go of just now, see HandOver
+      if (cr->MarkQueued()) {
+        from->ready_queue.at(cr->priority()).Enqueue(cr);
+        from->parking_lot.UnparkOne();
+      }
+      return false;
+    }
+    while (from->parking_lot.UnparkOne()) {
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(10));
+  }
+  from->migrations.fetch_sub(1);
+  cr->set_group_name(group_name);
+  cr->set_group(to);
+  cr->set_processor_slot(-1);
+  cr->set_migrating(false);
+  // runs once in the new group, a waiting one is put back to wait there
+  to->ready_queue.at(cr->priority()).Enqueue(cr);
+  to->parking_lot.UnparkOne();
+  return true;
 }
 
 }  // namespace scheduler
@@ -27,6 +27,9 @@
 
 #include "cyber/base/atomic_rw_lock.h"
 #include "cyber/croutine/croutine.h"
+#include "cyber/scheduler/policy/parking_lot.h"
+#include "cyber/scheduler/policy/ready_queue.h"
+#include "cyber/scheduler/policy/sleep_queue.h"
 #include "cyber/scheduler/processor_context.h"
 
 namespace apollo {
@@ -34,6 +37,7 @@ namespace cyber {
 namespace scheduler {
 
 static constexpr uint32_t MAX_PRIO = 20;
+static constexpr int MAX_GROUP_PROCESSORS = ParkingLot::kSlots;
 
 #define DEFAULT_GROUP_NAME "default_grp"
 
@@ -42,37 +46,128 @@ using MULTI_PRIO_QUEUE = std::array<CROUTINE_QUEUE, MAX_PRIO>;
 using CR_GROUP = std::unordered_map<std::string, MULTI_PRIO_QUEUE>;
 using LOCK_QUEUE = std::array<base::AtomicRWLock, MAX_PRIO>;
 using RQ_LOCK_GROUP = std::unordered_map<std::string, LOCK_QUEUE>;
+using MULTI_PRIO_READY_QUEUE = std::array<ReadyQueue, MAX_PRIO>;
 
-using GRP_WQ_MUTEX = std::unordered_map<std::string, std::mutex>;
-using GRP_WQ_CV = std::unordered_map<std::string, std::condition_variable>;
+// Slots of the single processors of a group, where they park and, if the
+// group steals work, their local ready queues. A context takes a slot for
+// its lifetime, slots and their queues are never freed, so a routine queued
+// on a slot whose context went away is still safe to steal.
+class LocalQueues {
+ public:
+  LocalQueues() {
+    for (auto &queue : queues_) {
+      queue.store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  // -1 if all slots are taken
+  int Acquire(bool local_queue);
+  void Release(int index);
+
+  // nullptr unless the slot has a local queue
+  MULTI_PRIO_READY_QUEUE *Get(int index) const {
+    if (index < 0 || index >= MAX_GROUP_PROCESSORS) {
+      return nullptr;
+    }
+    return queues_[index].load(std::memory_order_acquire);
+  }
+
+  int size() const { return size_.load(std::memory_order_acquire); }
 
+ private:
+  std::array<std::atomic<MULTI_PRIO_READY_QUEUE *>, MAX_GROUP_PROCESSORS>
+      queues_;
+  std::array<bool, MAX_GROUP_PROCESSORS> used_ = {};
+  std::atomic<int> size_ = {0};
+  std::mutex mutex_;
+};
+
+// What the processors of a group share, looked up once per wakeup.
+struct ClassicGroup {
+  MULTI_PRIO_READY_QUEUE ready_queue;
+  LocalQueues local_queues;
+  ParkingLot parking_lot;
+  // routines Migrate is waiting for, sleepers are looked through for them
+  // while there are any
+  std::atomic<int> migrations = {0};
+};
+using CLASSIC_GROUP = std::unordered_map<std::string, ClassicGroup>;
+
+// Processors of a group only ever look at the group's ready queues, a
+// routine gets queued when it is dispatched and when its data arrives, and
+// goes back to the queue right after it ran as long as it stays ready.
+// cr_group_ keeps every routine of the group for the removal of tasks.
+//
+// With work stealing every processor also has a local ready queue. A routine
+// goes back to the local queue of the processor that ran it last, so it
+// keeps running where its data is cached. A processor out of work takes
+// from the shared queues first and steals from its siblings after that.
+//
+// Idle processors park in the group's ParkingLot. Queuing a routine wakes
+// the processor that ran it last if that one is idle, any idle one else.
+// A processor leaving work behind in its local queue wakes a thief.
 class ClassicContext : public ProcessorContext {
  public:
   ClassicContext();
-  explicit ClassicContext(const std::string &group_name);
+  explicit ClassicContext(const std::string &group_name,
+                          bool work_stealing = false);
+  ~ClassicContext();
 
   std::shared_ptr<CRoutine> NextRoutine() override;
   void Wait() override;
   void Shutdown() override;
-
-  static void Notify(const std::string &group_name);
+  void BeginSpin() override;
+  void EndSpin() override;
+
+  // Puts |cr| on its group's ready queue and wakes a processor of the group,
+  // unless it is queued or running already. Whoever owns it then finds its
+  // update flag.
+  static void Enqueue(const std::shared_ptr<CRoutine> &cr);
+
+  // Moves |cr| to the ready queues of |group_name|. Whoever holds it queued
+  // in its old group hands it over the next time it would queue it again,
+  // the processors of the old group are woken for that. False if |cancel|
+  // returned true, the routine finished before it was handed over or
+  // either group has no processors.
+  static bool Migrate(const std::shared_ptr<CRoutine> &cr,
+                      const std::string &group_name,
+                      const std::function<bool()> &cancel);
 
   alignas(CACHELINE_SIZE) static RQ_LOCK_GROUP rq_locks_;
   alignas(CACHELINE_SIZE) static CR_GROUP cr_group_;
-
-  alignas(CACHELINE_SIZE) static GRP_WQ_MUTEX mtx_wq_;
-  alignas(CACHELINE_SIZE) static GRP_WQ_CV cv_wq_;
+  alignas(CACHELINE_SIZE) static CLASSIC_GROUP groups_;
 
  private:
-  void InitGroup(const std::string &group_name);
+  // nullptr if no processor of |group_name| exists
+  static ClassicGroup *FindGroup(const std::string &group_name);
+  // the group of |cr|, cached on the routine after the first lookup
+  static ClassicGroup *GroupOf(const std::shared_ptr<CRoutine> &cr);
 
-  std::chrono::steady_clock::time_point wake_time_;
-  bool need_sleep_ = false;
+  // guards insertions into groups_ against the lookups of uncached routines
+  static std::mutex groups_mutex_;
 
-  MULTI_PRIO_QUEUE *multi_pri_rq_ = nullptr;
-  LOCK_QUEUE *lq_ = nullptr;
-  std::mutex *mtx_ptr_ = nullptr;
-  std::condition_variable *cv_ptr_ = nullptr;
+  void InitGroup(const std::string &group_name);
+  bool HasReady() const;
+  bool Dequeue(std::shared_ptr<CRoutine> *cr);
+  bool Steal(std::shared_ptr<CRoutine> *cr);
+  MULTI_PRIO_READY_QUEUE *HomeQueue() const {
+    return local_queue_ != nullptr ? local_queue_ : ready_queue_;
+  }
+  // Puts a routine this context dequeued back according to its state.
+  void Requeue(const std::shared_ptr<CRoutine> &cr);
+  // Lets go of a routine Migrate waits for.
+  void HandOver(const std::shared_ptr<CRoutine> &cr);
+  void WakeSleepers();
+
+  // the routine returned last, requeued on the next call to NextRoutine
+  std::shared_ptr<CRoutine> current_;
+  SleepQueue<std::shared_ptr<CRoutine>> sleepers_;
+
+  ClassicGroup *group_ = nullptr;
+  MULTI_PRIO_READY_QUEUE *ready_queue_ = nullptr;
+  LocalQueues *siblings_ = nullptr;
+  MULTI_PRIO_READY_QUEUE *local_queue_ = nullptr;
+  int slot_ = -1;
 };
 
 }  // namespace scheduler
@@ -0,0 +1,246 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/edf_context.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "cyber/common/log.h"
+#include "cyber/event/perf_event_cache.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::croutine::RoutineState;
+using apollo::cyber::event::PerfEventCache;
+using apollo::cyber::event::SchedPerf;
+
+void EdfRunQueue::Enqueue(const std::shared_ptr<EdfTask>& task,
+                          const Clock::time_point& deadline) {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!task->cr->MarkQueued()) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  deadline.time_since_epoch())
+                  .count();
+    auto pending = task->wake_deadline_ns.load();
+    while ((pending == 0 || ns < pending) &&
+           !task->wake_deadline_ns.compare_exchange_weak(pending, ns)) {
+    }
+    return;
+  }
+  task->wake_deadline_ns.store(0);
+  task->deadline = deadline;
+  Push(task);
+  parking_lot_.UnparkOne();
+}
+
+void EdfRunQueue::Push(const std::shared_ptr<EdfTask>& task) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  heap_.push_back(Entry{task->deadline, seq_++, task});
+  std::push_heap(heap_.begin(), heap_.end(), Later());
+  size_.store(heap_.size(), std::memory_order_release);
+}
+
+bool EdfRunQueue::Pop(std::shared_ptr<EdfTask>* task) {
+  if (Empty()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (heap_.empty()) {
+    return false;
+  }
+  std::pop_heap(heap_.begin(), heap_.end(), Later());
+  *task = std::move(heap_.back().task);
+  heap_.pop_back();
+  size_.store(heap_.size(), std::memory_order_release);
+  return true;
+}
+
+int EdfRunQueue::AcquireSlot() {
+  int slot = slots_.fetch_add(1);
+  return slot < ParkingLot::kSlots ? slot : -1;
+}
+
+EdfContext::EdfContext(const std::shared_ptr<EdfRunQueue>& run_queue)
+    : run_queue_(run_queue) {
+  slot_ = run_queue_->AcquireSlot();
+  if (slot_ < 0) {
+    AWARN << "more than " << ParkingLot::kSlots
+          << " edf processors, the rest polls instead of parking.";
+  }
+}
+
+std::shared_ptr<CRoutine> EdfContext::NextRoutine() {
+  if (unlikely(stop_.load())) {
+    return nullptr;
+  }
+
+  if (current_ != nullptr) {
+    auto task = std::move(current_);
+    current_ = nullptr;
+    Requeue(task, true);
+  }
+
+  if (unlikely(!sleepers_.Empty())) {
+    WakeSleepers();
+  }
+
+  std::shared_ptr<EdfTask> task;
+  while (run_queue_->Pop(&task)) {
+    auto& cr = task->cr;
+    // a queued routine runs nowhere else, only a requeue or a removal
+    // may hold it for a moment
+    while (!cr->Acquire()) {
+      cpu_relax();
+    }
+
+    if (cr->UpdateState() == RoutineState::READY) {
+      // notifications that came in while it was queued start no activation
+      // of their own, their deadline must not outlive this one
+      task->wake_deadline_ns.store(0);
+      PerfEventCache::Instance()->AddSchedEvent(SchedPerf::NEXT_RT, cr->id(),
+                                                cr->processor_id());
+      current_ = task;
+      return cr;
+    }
+
+    cr->Release();
+    Requeue(task, false);
+  }
+
+  return nullptr;
+}
+
+void EdfContext::Requeue(const std::shared_ptr<EdfTask>& task, bool ran) {
+  auto& cr = task->cr;
+  while (!cr->Acquire()) {
+    cpu_relax();
+  }
+  // ready before the update only if it yielded within its activation
+  bool yielded = cr->state() == RoutineState::READY;
+  auto state = cr->UpdateState();
+  cr->Release();
+
+  if (ran && !yielded) {
+    Complete(task.get());
+  }
+  if (state == RoutineState::READY) {
+    if (!yielded) {
+      // notified while it ran, the next activation starts now
+      task->deadline = WakeDeadline(task.get());
+    }
+    run_queue_->Push(task);
+    return;
+  }
+  if (state == RoutineState::SLEEP) {
+    sleepers_.Push(cr->wake_time(), task);
+    return;
+  }
+  if (state == RoutineState::FINISHED) {
+    // stays marked queued, nothing is going to run it again
+    return;
+  }
+
+  // Waiting for data, from now on a notification queues it. One that came
+  // in while it was still marked queued has only cleared its update flag.
+  cr->ClearQueued();
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (cr->Acquire()) {
+    if (cr->UpdateState() == RoutineState::READY && cr->MarkQueued()) {
+      task->deadline = WakeDeadline(task.get());
+      run_queue_->Push(task);
+    }
+    cr->Release();
+  }
+}
+
+void EdfContext::Complete(EdfTask* task) {
+  task->activations.fetch_add(1, std::memory_order_relaxed);
+  auto lateness = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      EdfTask::Clock::now() - task->deadline)
+                      .count();
+  if (lateness <= 0) {
+    return;
+  }
+  task->deadline_misses.fetch_add(1, std::memory_order_relaxed);
+  auto max = task->max_lateness_ns.load(std::memory_order_relaxed);
+  while (lateness > max && !task->max_lateness_ns.compare_exchange_weak(
+                               max, lateness, std::memory_order_relaxed)) {
+  }
+}
+
+EdfTask::Clock::time_point EdfContext::WakeDeadline(EdfTask* task) {
+  auto ns = task->wake_deadline_ns.exchange(0);
+  if (ns == 0) {
+    // the notification has not stored it yet or did not ask for one
+    return EdfTask::Clock::now() + task->relative_deadline;
+  }
+  return EdfTask::Clock::time_point(std::chrono::nanoseconds(ns));
+}
+
+void EdfContext::WakeSleepers() {
+  auto now = EdfTask::Clock::now();
+  std::shared_ptr<EdfTask> task;
+  while (sleepers_.PopDue(now, &task)) {
+    // released at its wake time, not when we got around to it
+    task->deadline = task->cr->wake_time() + task->relative_deadline;
+    run_queue_->Push(task);
+  }
+}
+
+void EdfContext::Wait() {
+  if (stop_.load()) {
+    return;
+  }
+
+  auto deadline = sleepers_.NextWake();
+
+  if (unlikely(slot_ < 0)) {
+    std::this_thread::sleep_until(
+        std::min(deadline, ParkingLot::Clock::now() +
+                               std::chrono::milliseconds(1)));
+    return;
+  }
+
+  run_queue_->parking_lot()->Park(
+      slot_, [this]() { return stop_.load() || !run_queue_->Empty(); },
+      deadline);
+}
+
+void EdfContext::BeginSpin() {
+  if (slot_ >= 0) {
+    run_queue_->parking_lot()->BeginSpin(slot_);
+  }
+}
+
+void EdfContext::EndSpin() {
+  if (slot_ >= 0) {
+    run_queue_->parking_lot()->EndSpin(slot_);
+  }
+}
+
+void EdfContext::Shutdown() {
+  stop_.exchange(true);
+  if (slot_ >= 0) {
+    run_queue_->parking_lot()->Unpark(slot_);
+  }
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
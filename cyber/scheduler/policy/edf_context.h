@@ -0,0 +1,137 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_POLICY_EDF_CONTEXT_H_
+#define CYBER_SCHEDULER_POLICY_EDF_CONTEXT_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "cyber/croutine/croutine.h"
+#include "cyber/scheduler/policy/parking_lot.h"
+#include "cyber/scheduler/policy/sleep_queue.h"
+#include "cyber/scheduler/processor_context.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using croutine::CRoutine;
+
+// A routine under the edf policy. Every activation, from the routine being
+// woken until it waits again, has to complete within |relative_deadline|.
+struct EdfTask {
+  using Clock = std::chrono::steady_clock;
+
+  EdfTask(const std::shared_ptr<CRoutine>& cr,
+          const std::chrono::nanoseconds& relative_deadline)
+      : cr(cr), relative_deadline(relative_deadline) {}
+
+  std::shared_ptr<CRoutine> cr;
+  std::chrono::nanoseconds relative_deadline;
+  // of the pending activation, written by whoever queues the task
+  Clock::time_point deadline;
+  // earliest deadline asked for by notifications that came in while the
+  // task was queued or running, in ns since the clock's epoch, 0 for none
+  std::atomic<int64_t> wake_deadline_ns = {0};
+
+  std::atomic<uint64_t> activations = {0};
+  std::atomic<uint64_t> deadline_misses = {0};
+  std::atomic<int64_t> max_lateness_ns = {0};
+};
+
+// Ready tasks of all processors of the edf policy, earliest absolute
+// deadline first, and the ParkingLot their idle processors wait in.
+class EdfRunQueue {
+ public:
+  using Clock = EdfTask::Clock;
+
+  // Queues |task| due at |deadline| and wakes an idle processor, unless the
+  // task is queued or running already. Whoever owns it then finds its
+  // update flag and starts the next activation due at |deadline|.
+  void Enqueue(const std::shared_ptr<EdfTask>& task,
+               const Clock::time_point& deadline);
+
+  // for tasks marked queued already
+  void Push(const std::shared_ptr<EdfTask>& task);
+  bool Pop(std::shared_ptr<EdfTask>* task);
+  bool Empty() const { return size_.load(std::memory_order_acquire) == 0; }
+
+  // -1 once all slots of the ParkingLot are taken
+  int AcquireSlot();
+  ParkingLot* parking_lot() { return &parking_lot_; }
+
+ private:
+  struct Entry {
+    Clock::time_point deadline;
+    uint64_t seq;
+    std::shared_ptr<EdfTask> task;
+  };
+  // std::push_heap keeps the greatest on top, this makes it the earliest
+  struct Later {
+    bool operator()(const Entry& a, const Entry& b) const {
+      return a.deadline != b.deadline ? a.deadline > b.deadline : a.seq > b.seq;
+    }
+  };
+
+  std::mutex mutex_;
+  std::vector<Entry> heap_;
+  uint64_t seq_ = 0;
+  std::atomic<size_t> size_ = {0};
+  std::atomic<int> slots_ = {0};
+  ParkingLot parking_lot_;
+};
+
+// Processor context of the edf policy. All processors share one run queue
+// and always pick the ready routine with the earliest absolute deadline, a
+// routine that yields ready keeps the deadline of its activation. Finishing
+// an activation after its deadline counts as a deadline miss.
+class EdfContext : public ProcessorContext {
+ public:
+  explicit EdfContext(const std::shared_ptr<EdfRunQueue>& run_queue);
+
+  std::shared_ptr<CRoutine> NextRoutine() override;
+  void Wait() override;
+  void Shutdown() override;
+  void BeginSpin() override;
+  void EndSpin() override;
+
+ private:
+  // Puts a task this context dequeued back according to its state, |ran|
+  // tells whether it just completed an activation.
+  void Requeue(const std::shared_ptr<EdfTask>& task, bool ran);
+  void Complete(EdfTask* task);
+  // deadline of a new activation of |task| starting now
+  static EdfTask::Clock::time_point WakeDeadline(EdfTask* task);
+  void WakeSleepers();
+
+  // the task returned last, requeued on the next call to NextRoutine
+  std::shared_ptr<EdfTask> current_;
+  SleepQueue<std::shared_ptr<EdfTask>> sleepers_;
+
+  std::shared_ptr<EdfRunQueue> run_queue_;
+  int slot_ = -1;
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_POLICY_EDF_CONTEXT_H_
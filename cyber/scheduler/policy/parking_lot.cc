@@ -0,0 +1,155 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/parking_lot.h"
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+namespace {
+
+int* FutexWord(std::atomic<uint32_t>* word) {
+  return reinterpret_cast<int*>(word);
+}
+
+// Sleeps while |word| holds |value|, until woken or |deadline| passed.
+void FutexWait(std::atomic<uint32_t>* word, uint32_t value,
+               ParkingLot::Clock::time_point deadline) {
+  struct timespec timeout;
+  struct timespec* timeout_ptr = nullptr;
+  if (deadline != ParkingLot::Clock::time_point::max()) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  deadline - ParkingLot::Clock::now())
+                  .count();
+    if (ns <= 0) {
+      return;
+    }
+    timeout.tv_sec = ns / 1000000000;
+    timeout.tv_nsec = ns % 1000000000;
+    timeout_ptr = &timeout;
+  }
+  syscall(SYS_futex, FutexWord(word), FUTEX_WAIT_PRIVATE, value, timeout_ptr,
+          nullptr, 0);
+}
+
+void FutexWake(std::atomic<uint32_t>* word) {
+  syscall(SYS_futex, FutexWord(word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr,
+          0);
+}
+
+}  // namespace
+
+void ParkingLot::Park(int slot, const std::function<bool()>& has_work,
+                      Clock::time_point deadline) {
+  auto& word = words_[slot].parked;
+  word.store(1, std::memory_order_relaxed);
+  idle_[slot / 64].fetch_or(Bit(slot), std::memory_order_seq_cst);
+  // pairs with the fence in UnparkOne
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  if (!has_work()) {
+    // returns at once if a waker cleared the word meanwhile
+    FutexWait(&word, 1, deadline);
+  }
+
+  Claim(slot);
+  word.store(0, std::memory_order_relaxed);
+}
+
+bool ParkingLot::UnparkOne(int preferred) {
+  // pairs with the fence in Park
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (ClaimSpinner(preferred)) {
+    return true;
+  }
+  if (preferred >= 0 && preferred < kSlots && Idle(preferred) &&
+      Claim(preferred)) {
+    Wake(preferred);
+    return true;
+  }
+  for (int i = 0; i < kSlots / 64; ++i) {
+    uint64_t idle = idle_[i].load(std::memory_order_acquire);
+    while (idle != 0) {
+      int slot = i * 64 + __builtin_ctzll(idle);
+      if (Claim(slot)) {
+        Wake(slot);
+        return true;
+      }
+      idle &= idle - 1;
+    }
+  }
+  return false;
+}
+
+bool ParkingLot::ClaimSpinner(int preferred) {
+  auto claim = [](std::atomic<uint64_t>* word, uint64_t bit) {
+    return (word->fetch_and(~bit, std::memory_order_acq_rel) & bit) != 0;
+  };
+  if (preferred >= 0 && preferred < kSlots) {
+    auto& word = spinning_[preferred / 64];
+    if ((word.load(std::memory_order_acquire) & Bit(preferred)) != 0 &&
+        claim(&word, Bit(preferred))) {
+      return true;
+    }
+  }
+  for (auto& word : spinning_) {
+    uint64_t spinning = word.load(std::memory_order_acquire);
+    while (spinning != 0) {
+      if (claim(&word, spinning & -spinning)) {
+        return true;
+      }
+      spinning &= spinning - 1;
+    }
+  }
+  return false;
+}
+
+void ParkingLot::Unpark(int slot) {
+  Claim(slot);
+  Wake(slot);
+}
+
+void ParkingLot::Wake(int slot) {
+  auto& word = words_[slot].parked;
+  word.store(0, std::memory_order_release);
+  FutexWake(&word);
+}
+
+void Parker::Park(Clock::time_point deadline) {
+  uint32_t state = RUNNING;
+  if (state_.compare_exchange_strong(state, PARKED,
+                                     std::memory_order_acq_rel)) {
+    FutexWait(&state_, PARKED, deadline);
+  }
+  // consumes the notification, the caller looks for work next
+  state_.store(RUNNING, std::memory_order_seq_cst);
+}
+
+void Parker::Unpark() {
+  if (state_.exchange(NOTIFIED, std::memory_order_acq_rel) == PARKED) {
+    FutexWake(&state_);
+  }
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
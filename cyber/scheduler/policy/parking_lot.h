@@ -0,0 +1,122 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_POLICY_PARKING_LOT_H_
+#define CYBER_SCHEDULER_POLICY_PARKING_LOT_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+#include "cyber/base/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+// Where the idle processors of a group sleep. Every processor parks on a
+// futex word of its own slot and is marked in an idle bitmap, a waker
+// claims a single marked slot by clearing its bit and wakes exactly that
+// one, without taking any lock.
+//
+// A processor marks itself idle before it checks for work one last time,
+// a waker publishes work before it looks for an idle slot. Either the
+// processor sees the work or the waker sees it idle, so no wakeup is lost.
+//
+// A processor polling for work before it parks marks itself spinning. A
+// waker claims a spinning slot before an idle one and wakes nobody then,
+// the spinner finds the work by itself, or when it checks once more on
+// parking.
+class ParkingLot {
+ public:
+  static constexpr int kSlots = 128;
+
+  using Clock = std::chrono::steady_clock;
+
+  // Parks |slot| until it is unparked or |deadline| passed, unless
+  // |has_work| returns true once the slot is marked idle. May return early,
+  // callers check for work again anyway.
+  void Park(int slot, const std::function<bool()>& has_work,
+            Clock::time_point deadline = Clock::time_point::max());
+
+  // Wakes one idle slot, |preferred| if that one is idle, unless it can
+  // claim a spinning one. False if no slot was idle or spinning, all of
+  // them are going to look for work by themselves then.
+  bool UnparkOne(int preferred = -1);
+
+  // Brackets the polling of |slot| before it parks.
+  void BeginSpin(int slot) {
+    spinning_[slot / 64].fetch_or(Bit(slot), std::memory_order_seq_cst);
+  }
+  void EndSpin(int slot) {
+    spinning_[slot / 64].fetch_and(~Bit(slot), std::memory_order_relaxed);
+  }
+
+  // Wakes |slot| whether it is parked or just about to, for conditions
+  // |has_work| checks besides queued work, like a shutdown.
+  void Unpark(int slot);
+
+  bool Idle(int slot) const {
+    return (idle_[slot / 64].load(std::memory_order_acquire) & Bit(slot)) != 0;
+  }
+
+ private:
+  static uint64_t Bit(int slot) { return uint64_t(1) << (slot % 64); }
+
+  bool Claim(int slot) {
+    return (idle_[slot / 64].fetch_and(~Bit(slot), std::memory_order_acq_rel) &
+            Bit(slot)) != 0;
+  }
+
+  bool ClaimSpinner(int preferred);
+
+  void Wake(int slot);
+
+  // 1 while parked, the futex word
+  struct alignas(CACHELINE_SIZE) Word {
+    std::atomic<uint32_t> parked = {0};
+  };
+
+  alignas(CACHELINE_SIZE) std::array<std::atomic<uint64_t>, kSlots / 64> idle_ =
+      {};
+  alignas(CACHELINE_SIZE)
+      std::array<std::atomic<uint64_t>, kSlots / 64> spinning_ = {};
+  std::array<Word, kSlots> words_;
+};
+
+// Parking for a processor of its own, woken by whoever queues work on it.
+// A notification that comes in while the processor is running is kept,
+// its next Park returns at once, so none is lost.
+class Parker {
+ public:
+  using Clock = ParkingLot::Clock;
+
+  void Park(Clock::time_point deadline = Clock::time_point::max());
+  void Unpark();
+
+ private:
+  enum : uint32_t { RUNNING, PARKED, NOTIFIED };
+
+  alignas(CACHELINE_SIZE) std::atomic<uint32_t> state_ = {RUNNING};
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_POLICY_PARKING_LOT_H_
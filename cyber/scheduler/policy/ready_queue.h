@@ -0,0 +1,166 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_POLICY_READY_QUEUE_H_
+#define CYBER_SCHEDULER_POLICY_READY_QUEUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "cyber/base/macros.h"
+#include "cyber/croutine/croutine.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using croutine::CRoutine;
+
+// Multi-producer multi-consumer queue of the croutines ready to run. The
+// ring is lock free, each cell carries a sequence number telling whether
+// it is free for the producer or filled for the consumer of the current
+// lap. A routine is queued at most once at a time, so the ring only runs
+// full when more routines than its capacity share a priority. Those spill
+// into a locked overflow list instead of being dropped. While that list is
+// not empty later routines queue up behind it, and every dequeue moves its
+// head into the cells freed, so no routine is passed over.
+class ReadyQueue {
+ public:
+  static constexpr uint64_t kCapacity = 256;
+
+  ReadyQueue() : cells_(new Cell[kCapacity]) {
+    for (uint64_t i = 0; i < kCapacity; ++i) {
+      cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  void Enqueue(const std::shared_ptr<CRoutine>& cr) {
+    if (unlikely(overflow_size_.load(std::memory_order_acquire) != 0)) {
+      std::lock_guard<std::mutex> lock(overflow_mutex_);
+      if (!overflow_.empty()) {
+        PushOverflow(cr);
+        return;
+      }
+    }
+    if (!TryPush(cr)) {
+      std::lock_guard<std::mutex> lock(overflow_mutex_);
+      PushOverflow(cr);
+    }
+  }
+
+  bool Dequeue(std::shared_ptr<CRoutine>* cr) {
+    uint64_t pos = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = cells_[pos & (kCapacity - 1)];
+      uint64_t seq = cell.seq.load(std::memory_order_acquire);
+      if (seq == pos + 1) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          *cr = std::move(cell.cr);
+          cell.seq.store(pos + kCapacity, std::memory_order_release);
+          Refill();
+          return true;
+        }
+      } else if (seq < pos + 1) {
+        // empty
+        return DequeueOverflow(cr);
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool Empty() const {
+    return head_.load(std::memory_order_acquire) ==
+               tail_.load(std::memory_order_acquire) &&
+           overflow_size_.load(std::memory_order_acquire) == 0;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<uint64_t> seq;
+    std::shared_ptr<CRoutine> cr;
+  };
+
+  // false if the ring is full
+  bool TryPush(const std::shared_ptr<CRoutine>& cr) {
+    uint64_t pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = cells_[pos & (kCapacity - 1)];
+      uint64_t seq = cell.seq.load(std::memory_order_acquire);
+      if (seq == pos) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          cell.cr = cr;
+          cell.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (seq < pos) {
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // with overflow_mutex_ held
+  void PushOverflow(const std::shared_ptr<CRoutine>& cr) {
+    overflow_.push_back(cr);
+    overflow_size_.fetch_add(1, std::memory_order_release);
+  }
+
+  // moves the oldest overflowed routines into the free cells, in order
+  void Refill() {
+    if (likely(overflow_size_.load(std::memory_order_acquire) == 0)) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(overflow_mutex_);
+    while (!overflow_.empty() && TryPush(overflow_.front())) {
+      overflow_.pop_front();
+      overflow_size_.fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+  bool DequeueOverflow(std::shared_ptr<CRoutine>* cr) {
+    if (likely(overflow_size_.load(std::memory_order_acquire) == 0)) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(overflow_mutex_);
+    if (overflow_.empty()) {
+      return false;
+    }
+    *cr = std::move(overflow_.front());
+    overflow_.pop_front();
+    overflow_size_.fetch_sub(1, std::memory_order_release);
+    return true;
+  }
+
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> head_ = {0};
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> tail_ = {0};
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> overflow_size_ = {0};
+  std::unique_ptr<Cell[]> cells_;
+  std::mutex overflow_mutex_;
+  std::deque<std::shared_ptr<CRoutine>> overflow_;
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_POLICY_READY_QUEUE_H_
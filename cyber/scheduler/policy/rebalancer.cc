@@ -0,0 +1,83 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/rebalancer.h"
+
+#include <algorithm>
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+namespace {
+
+double Load(const GroupLoad& group, uint64_t extra_ns = 0) {
+  if (group.capacity_ns == 0) {
+    return 1.0;
+  }
+  return static_cast<double>(group.busy_ns + extra_ns) /
+         static_cast<double>(group.capacity_ns);
+}
+
+}  // namespace
+
+std::vector<Migration> PlanMigrations(
+    const RebalanceConf& conf,
+    std::unordered_map<std::string, GroupLoad> groups,
+    std::vector<TaskLoad> tasks) {
+  std::vector<Migration> migrations;
+  std::stable_sort(tasks.begin(), tasks.end(),
+                   [](const TaskLoad& a, const TaskLoad& b) {
+                     return a.busy_ns > b.busy_ns;
+                   });
+
+  for (auto& task : tasks) {
+    if (migrations.size() >= conf.max_migrations() || task.busy_ns == 0) {
+      break;
+    }
+    auto from = groups.find(task.group);
+    if (from == groups.end() || Load(from->second) <= conf.high_load()) {
+      continue;
+    }
+
+    GroupLoad* best = nullptr;
+    const std::string* best_name = nullptr;
+    for (auto& name : task.groups) {
+      auto to = groups.find(name);
+      if (to == groups.end() || to == from ||
+          Load(to->second) >= conf.low_load() ||
+          Load(to->second, task.busy_ns) > conf.high_load()) {
+        continue;
+      }
+      if (best == nullptr || Load(to->second) < Load(*best)) {
+        best = &to->second;
+        best_name = &to->first;
+      }
+    }
+    if (best == nullptr) {
+      continue;
+    }
+
+    from->second.busy_ns -= std::min(from->second.busy_ns, task.busy_ns);
+    best->busy_ns += task.busy_ns;
+    migrations.push_back({task.name, *best_name});
+  }
+  return migrations;
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,65 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_POLICY_REBALANCER_H_
+#define CYBER_SCHEDULER_POLICY_REBALANCER_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cyber/proto/classic_conf.pb.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::proto::RebalanceConf;
+
+// Run time of a group's tasks and what its processors could have run over
+// the same interval.
+struct GroupLoad {
+  uint64_t busy_ns = 0;
+  uint64_t capacity_ns = 0;
+};
+
+struct TaskLoad {
+  std::string name;
+  std::string group;
+  uint64_t busy_ns = 0;
+  // groups it may be moved to
+  std::vector<std::string> groups;
+};
+
+struct Migration {
+  std::string name;
+  std::string group;
+};
+
+// Picks the moves of one rebalancing round. The busiest tasks of groups
+// above |conf.high_load| go to the least loaded of their groups that is
+// below |conf.low_load| and stays below |conf.high_load| with them.
+std::vector<Migration> PlanMigrations(
+    const RebalanceConf& conf,
+    std::unordered_map<std::string, GroupLoad> groups,
+    std::vector<TaskLoad> tasks);
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_POLICY_REBALANCER_H_
@@ -68,15 +68,23 @@ SchedulerChoreography::SchedulerChoreography() {
     choreography_processor_prio_ =
         choreography_conf.choreography_processor_prio();
     ParseCpuset(choreography_conf.choreography_cpuset(), &choreography_cpuset_);
+    choreography_idle_spin_ = std::chrono::microseconds(
+        choreography_conf.choreography_idle_spin_us());
+    choreography_busy_poll_ = choreography_conf.choreography_busy_poll();
 
     task_pool_size_ = choreography_conf.pool_processor_num();
     pool_affinity_ = choreography_conf.pool_affinity();
     pool_processor_policy_ = choreography_conf.pool_processor_policy();
     pool_processor_prio_ = choreography_conf.pool_processor_prio();
     ParseCpuset(choreography_conf.pool_cpuset(), &pool_cpuset_);
+    pool_idle_spin_ =
+        std::chrono::microseconds(choreography_conf.pool_idle_spin_us());
 
     for (const auto& task : choreography_conf.tasks()) {
       cr_confs_[task.name()] = task;
+      if (task.has_stack_size()) {
+        stack_sizes_[task.name()] = task.stack_size();
+      }
     }
   }
 
@@ -95,9 +103,21 @@ SchedulerChoreography::SchedulerChoreography() {
 }
 
 void SchedulerChoreography::CreateProcessor() {
+  // choreography processors first, they run the pinned tasks
+  if (choreography_affinity_ == "auto") {
+    choreography_cpuset_ =
+        AutoAffinity("choreography", choreography_cpuset_, proc_num_);
+    choreography_affinity_ = "1to1";
+  }
+  if (pool_affinity_ == "auto") {
+    pool_cpuset_ = AutoAffinity("pool", pool_cpuset_, task_pool_size_);
+    pool_affinity_ = "1to1";
+  }
+
   for (uint32_t i = 0; i < proc_num_; i++) {
     auto proc = std::make_shared<Processor>();
     auto ctx = std::make_shared<ChoreographyContext>();
+    ctx->SetIdleSpin(choreography_idle_spin_, choreography_busy_poll_);
 
     proc->BindContext(ctx);
     proc->SetSchedAffinity(choreography_cpuset_, choreography_affinity_, i);
@@ -110,6 +130,7 @@ void SchedulerChoreography::CreateProcessor() {
   for (uint32_t i = 0; i < task_pool_size_; i++) {
     auto proc = std::make_shared<Processor>();
     auto ctx = std::make_shared<ClassicContext>();
+    ctx->SetIdleSpin(pool_idle_spin_);
 
     proc->BindContext(ctx);
     proc->SetSchedAffinity(pool_cpuset_, pool_affinity_, i);
@@ -177,6 +198,7 @@ bool SchedulerChoreography::DispatchTask(const std::shared_ptr<CRoutine>& cr) {
           .at(cr->priority())
           .emplace_back(cr);
     }
+    ClassicContext::Enqueue(cr);
   }
   return true;
 }
@@ -255,6 +277,64 @@ bool SchedulerChoreography::RemoveCRoutine(uint64_t crid) {
   return false;
 }
 
+bool SchedulerChoreography::MigrateTask(const std::string& name,
+                                        int processor) {
+  if (unlikely(stop_.load())) {
+    return false;
+  }
+  if (processor < 0 || processor >= static_cast<int>(proc_num_)) {
+    AWARN << "cannot move task " << name << ", no choreography processor "
+          << processor;
+    return false;
+  }
+
+  // we use multi-key mutex to prevent race condition
+  // when del && add cr with same crid
+  auto crid = GlobalData::GenerateHashId(name);
+  MutexWrapper wrapper;
+  {
+    std::lock_guard<std::mutex> wl_lg(cr_wl_mtx_);
+    auto iter = id_map_mutex_.find(crid);
+    if (iter != id_map_mutex_.end()) {
+      wrapper = iter->second;
+    } else {
+      wrapper = std::make_shared<std::mutex>();
+      id_map_mutex_.emplace(crid, wrapper);
+    }
+  }
+  std::lock_guard<std::mutex> lg(*wrapper);
+
+  int pid;
+  {
+    ReadLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    auto p = id_cr_.find(crid);
+    if (p == id_cr_.end()) {
+      return false;
+    }
+    pid = p->second->processor_id();
+  }
+  if (pid == processor) {
+    return true;
+  }
+  if (pid < 0 || pid >= static_cast<int>(proc_num_)) {
+    AWARN << "cannot move task " << name << ", it runs in the pool";
+    return false;
+  }
+
+  auto cr = static_cast<ChoreographyContext*>(pctxs_[pid].get())
+                ->TakeCRoutine(crid);
+  if (cr == nullptr) {
+    return false;
+  }
+  // a notification still going to the old processor has set the update
+  // flag already, the new one sees it once it is woken by Enqueue
+  cr->set_processor_id(processor);
+  static_cast<ChoreographyContext*>(pctxs_[processor].get())->Enqueue(cr);
+  AINFO << "moved task " << name << " from processor " << pid << " to "
+        << processor;
+  return true;
+}
+
 bool SchedulerChoreography::NotifyProcessor(uint64_t crid) {
   if (unlikely(stop_.load())) {
     return true;
@@ -283,7 +363,7 @@ bool SchedulerChoreography::NotifyProcessor(uint64_t crid) {
     auto pid = cr->processor_id();
     static_cast<ChoreographyContext*>(pctxs_[pid].get())->Notify();
   } else {
-    ClassicContext::Notify(cr->group_name());
+    ClassicContext::Enqueue(cr);
   }
 
   return true;
@@ -17,6 +17,7 @@
 #ifndef CYBER_SCHEDULER_POLICY_SCHEDULER_CHOREOGRAPHY_H_
 #define CYBER_SCHEDULER_POLICY_SCHEDULER_CHOREOGRAPHY_H_
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -39,6 +40,10 @@ class SchedulerChoreography : public Scheduler {
   bool RemoveTask(const std::string& name) override;
   bool DispatchTask(const std::shared_ptr<CRoutine>&) override;
 
+  using Scheduler::MigrateTask;
+  // between choreography processors, tasks of the pool stay there
+  bool MigrateTask(const std::string& name, int processor) override;
+
  private:
   friend Scheduler* Instance();
   SchedulerChoreography();
@@ -59,6 +64,10 @@ class SchedulerChoreography : public Scheduler {
 
   std::vector<int> choreography_cpuset_;
   std::vector<int> pool_cpuset_;
+
+  std::chrono::microseconds choreography_idle_spin_{0};
+  bool choreography_busy_poll_ = false;
+  std::chrono::microseconds pool_idle_spin_{0};
 };
 
 }  // namespace scheduler
@@ -23,6 +23,7 @@
 #include "cyber/common/environment.h"
 #include "cyber/common/file.h"
 #include "cyber/scheduler/policy/classic_context.h"
+#include "cyber/scheduler/policy/rebalancer.h"
 #include "cyber/scheduler/processor.h"
 
 namespace apollo {
@@ -60,6 +61,9 @@ SchedulerClassic::SchedulerClassic() {
       for (auto task : group.tasks()) {
         task.set_group_name(group_name);
         cr_confs_[task.name()] = task;
+        if (task.has_stack_size()) {
+          stack_sizes_[task.name()] = task.stack_size();
+        }
       }
     }
   } else {
@@ -79,6 +83,19 @@ SchedulerClassic::SchedulerClassic() {
   }
 
   CreateProcessor();
+  StartRebalancer();
+}
+
+SchedulerClassic::~SchedulerClassic() {
+  if (!rebalancer_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(rebalancer_mutex_);
+    stop_.store(true);
+  }
+  rebalancer_cv_.notify_all();
+  rebalancer_.join();
 }
 
 void SchedulerClassic::CreateProcessor() {
@@ -90,14 +107,29 @@ void SchedulerClassic::CreateProcessor() {
     // }
     task_pool_size_ = std::max(task_pool_size_, proc_num); // LIUJIAMING
 
-    auto& affinity = group.affinity();
+    auto affinity = group.affinity();
     auto& processor_policy = group.processor_policy();
     auto processor_prio = group.processor_prio();
     std::vector<int> cpuset;
     ParseCpuset(group.cpuset(), &cpuset);
+    if (affinity == "auto") {
+      cpuset = AutoAffinity(group_name, cpuset, proc_num);
+      affinity = "1to1";
+    }
+
+    std::chrono::microseconds idle_spin(group.processor_idle_spin_us());
+    if (group.processor_busy_poll()) {
+      AINFO << "processors of group " << group_name << " busy poll";
+      if (proc_num > 1 || cpuset.empty()) {
+        AWARN << "busy polling group " << group_name
+              << " is meant for a single processor on an isolated cpu";
+      }
+    }
 
     for (uint32_t i = 0; i < proc_num; i++) {
-      auto ctx = std::make_shared<ClassicContext>(group_name);
+      auto ctx =
+          std::make_shared<ClassicContext>(group_name, group.work_stealing());
+      ctx->SetIdleSpin(idle_spin, group.processor_busy_poll());
       pctxs_.emplace_back(ctx);
 
       auto proc = std::make_shared<Processor>();
@@ -109,6 +141,25 @@ void SchedulerClassic::CreateProcessor() {
   }
 }
 
+void SchedulerClassic::StartRebalancer() {
+  if (!classic_conf_.has_rebalance()) {
+    return;
+  }
+  last_rebalance_ = std::chrono::steady_clock::now();
+  rebalancer_ = std::thread([this]() {
+    auto interval =
+        std::chrono::milliseconds(classic_conf_.rebalance().interval_ms());
+    std::unique_lock<std::mutex> lock(rebalancer_mutex_);
+    while (!rebalancer_cv_.wait_for(lock, interval,
+                                    [this]() { return stop_.load(); })) {
+      lock.unlock();
+      Rebalance();
+      lock.lock();
+    }
+  });
+  SetInnerThreadAttr("rebalancer", &rebalancer_);
+}
+
 bool SchedulerClassic::DispatchTask(const std::shared_ptr<CRoutine>& cr) {
   // we use multi-key mutex to prevent race condition
   // when del && add cr with same crid
@@ -164,7 +215,7 @@ bool SchedulerClassic::DispatchTask(const std::shared_ptr<CRoutine>& cr) {
     }
   }
 
-  ClassicContext::Notify(cr->group_name()); // Notify for?
+  ClassicContext::Enqueue(cr);
   return true;
 }
 
@@ -177,19 +228,27 @@ bool SchedulerClassic::NotifyProcessor(uint64_t crid) {
     ReadLockGuard<AtomicRWLock> lk(id_cr_lock_);
     auto iter = id_cr_.find(crid);
     if (iter != id_cr_.end()) {
-      auto cr = iter->second;
-      if (cr->state() == RoutineState::DATA_WAIT ||
-          cr->state() == RoutineState::IO_WAIT) {
-        cr->SetUpdateFlag();
-      }
-
-      ClassicContext::Notify(cr->group_name());
-      return true;
+      return NotifyRoutine(iter->second);
     }
   }
   return false;
 }
 
+bool SchedulerClassic::NotifyRoutine(const std::shared_ptr<CRoutine>& cr) {
+  if (unlikely(stop_.load())) {
+    return true;
+  }
+  // A removed routine is stopped, if this queues it once more it finishes on
+  // its next resume and is not queued again.
+  if (cr->state() == RoutineState::DATA_WAIT ||
+      cr->state() == RoutineState::IO_WAIT) {
+    cr->SetUpdateFlag();
+  }
+
+  ClassicContext::Enqueue(cr);
+  return true;
+}
+
 bool SchedulerClassic::RemoveTask(const std::string& name) {
   if (unlikely(stop_.load())) {
     return true;
@@ -254,6 +313,127 @@ bool SchedulerClassic::RemoveCRoutine(uint64_t crid) {
   return false;
 }
 
+bool SchedulerClassic::MigrateTask(const std::string& name,
+                                   const std::string& group) {
+  if (unlikely(stop_.load())) {
+    return false;
+  }
+  auto& groups = classic_conf_.groups();
+  if (std::none_of(groups.begin(), groups.end(),
+                   [&group](const proto::SchedGroup& g) {
+                     return g.name() == group;
+                   })) {
+    AWARN << "cannot move task " << name << ", no group " << group;
+    return false;
+  }
+
+  // we use multi-key mutex to prevent race condition
+  // when del && add cr with same crid
+  auto crid = GlobalData::GenerateHashId(name);
+  MutexWrapper wrapper;
+  {
+    std::lock_guard<std::mutex> wl_lg(cr_wl_mtx_);
+    auto iter = id_map_mutex_.find(crid);
+    if (iter != id_map_mutex_.end()) {
+      wrapper = iter->second;
+    } else {
+      wrapper = std::make_shared<std::mutex>();
+      id_map_mutex_.emplace(crid, wrapper);
+    }
+  }
+
+  std::lock_guard<std::mutex> lg(*wrapper);
+
+  std::shared_ptr<CRoutine> cr;
+  {
+    ReadLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    auto iter = id_cr_.find(crid);
+    if (iter == id_cr_.end()) {
+      return false;
+    }
+    cr = iter->second;
+  }
+
+  // only changes while we hold the wrapper
+  auto from = cr->group_name();
+  if (from == group) {
+    return true;
+  }
+  if (!ClassicContext::Migrate(cr, group,
+                               [this]() { return stop_.load(); })) {
+    return false;
+  }
+
+  auto prio = cr->priority();
+  {
+    WriteLockGuard<AtomicRWLock> lk(ClassicContext::rq_locks_[from][prio]);
+    auto& cr_queue = ClassicContext::cr_group_[from][prio];
+    cr_queue.erase(std::remove(cr_queue.begin(), cr_queue.end(), cr),
+                   cr_queue.end());
+  }
+  {
+    WriteLockGuard<AtomicRWLock> lk(ClassicContext::rq_locks_[group][prio]);
+    ClassicContext::cr_group_[group][prio].emplace_back(cr);
+  }
+  AINFO << "moved task " << name << " from group " << from << " to "
+        << group;
+  return true;
+}
+
+void SchedulerClassic::Rebalance() {
+  std::lock_guard<std::mutex> lock(rebalance_mutex_);
+  auto now = std::chrono::steady_clock::now();
+  uint64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            now - last_rebalance_)
+                            .count();
+  last_rebalance_ = now;
+
+  std::unordered_map<std::string, GroupLoad> groups;
+  std::vector<TaskLoad> tasks;
+  std::unordered_map<uint64_t, uint64_t> run_ns;
+  for (auto& group : classic_conf_.groups()) {
+    auto& load = groups[group.name()];
+    load.capacity_ns = elapsed_ns * group.processor_num();
+    for (uint32_t prio = 0; prio < MAX_PRIO; ++prio) {
+      ReadLockGuard<AtomicRWLock> lk(
+          ClassicContext::rq_locks_[group.name()][prio]);
+      for (auto& cr : ClassicContext::cr_group_[group.name()][prio]) {
+        auto total = cr->stats().total_run_ns;
+        run_ns[cr->id()] = total;
+        // a task new to this round, or created anew under the same name
+        // since the last one, has no interval to go by
+        auto last = last_run_ns_.find(cr->id());
+        if (last == last_run_ns_.end() || total < last->second) {
+          continue;
+        }
+        uint64_t busy = total - last->second;
+        load.busy_ns += busy;
+
+        auto conf = cr_confs_.find(cr->name());
+        if (conf == cr_confs_.end() ||
+            conf->second.migrate_groups_size() == 0) {
+          continue;
+        }
+        TaskLoad task;
+        task.name = cr->name();
+        task.group = group.name();
+        task.busy_ns = busy;
+        task.groups.emplace_back(conf->second.group_name());
+        for (auto& name : conf->second.migrate_groups()) {
+          task.groups.emplace_back(name);
+        }
+        tasks.emplace_back(std::move(task));
+      }
+    }
+  }
+  last_run_ns_.swap(run_ns);
+
+  for (auto& migration : PlanMigrations(classic_conf_.rebalance(),
+                                        std::move(groups), std::move(tasks))) {
+    MigrateTask(migration.name, migration.group);
+  }
+}
+
 }  // namespace scheduler
 }  // namespace cyber
 }  // namespace apollo
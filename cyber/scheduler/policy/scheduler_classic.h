@@ -17,8 +17,12 @@
 #ifndef CYBER_SCHEDULER_POLICY_SCHEDULER_CLASSIC_H_
 #define CYBER_SCHEDULER_POLICY_SCHEDULER_CLASSIC_H_
 
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -36,20 +40,40 @@ using apollo::cyber::proto::ClassicTask;
 
 class SchedulerClassic : public Scheduler {
  public:
+  ~SchedulerClassic();
+
   bool RemoveCRoutine(uint64_t crid) override;
   bool RemoveTask(const std::string& name) override;
   bool DispatchTask(const std::shared_ptr<CRoutine>&) override;
 
+  using Scheduler::MigrateTask;
+  bool MigrateTask(const std::string& name, const std::string& group) override;
+
+  // One round of moving tasks between groups by their run time since the
+  // last round, see RebalanceConf. The rebalancer thread calls it every
+  // interval_ms if the conf has rebalance set.
+  void Rebalance();
+
  private:
   friend Scheduler* Instance();
   SchedulerClassic();
 
   void CreateProcessor();
+  void StartRebalancer();
   bool NotifyProcessor(uint64_t crid) override;
+  bool NotifyRoutine(const std::shared_ptr<CRoutine>& cr) override;
 
   std::unordered_map<std::string, ClassicTask> cr_confs_;
 
   ClassicConf classic_conf_;
+
+  std::thread rebalancer_;
+  std::mutex rebalancer_mutex_;
+  std::condition_variable rebalancer_cv_;
+  // guards the state of the last round
+  std::mutex rebalance_mutex_;
+  std::chrono::steady_clock::time_point last_rebalance_;
+  std::unordered_map<uint64_t, uint64_t> last_run_ns_;
 };
 
 }  // namespace scheduler
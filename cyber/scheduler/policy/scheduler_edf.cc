@@ -0,0 +1,253 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/scheduler_edf.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "cyber/common/environment.h"
+#include "cyber/common/file.h"
+#include "cyber/common/global_data.h"
+#include "cyber/scheduler/processor.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::base::ReadLockGuard;
+using apollo::cyber::base::WriteLockGuard;
+using apollo::cyber::common::GetAbsolutePath;
+using apollo::cyber::common::GetProtoFromFile;
+using apollo::cyber::common::GlobalData;
+using apollo::cyber::common::PathExists;
+using apollo::cyber::common::WorkRoot;
+using apollo::cyber::croutine::RoutineState;
+
+SchedulerEdf::SchedulerEdf() : run_queue_(new EdfRunQueue()) {
+  std::string conf("conf/");
+  conf.append(GlobalData::Instance()->ProcessGroup()).append(".conf");
+  auto cfg_file = GetAbsolutePath(WorkRoot(), conf);
+
+  apollo::cyber::proto::CyberConfig cfg;
+  if (PathExists(cfg_file) && GetProtoFromFile(cfg_file, &cfg)) {
+    for (auto& thr : cfg.scheduler_conf().threads()) {
+      inner_thr_confs_[thr.name()] = thr;
+    }
+
+    if (cfg.scheduler_conf().has_process_level_cpuset()) {
+      process_level_cpuset_ = cfg.scheduler_conf().process_level_cpuset();
+      ProcessLevelResourceControl();
+    }
+
+    edf_conf_ = cfg.scheduler_conf().edf_conf();
+    for (const auto& task : edf_conf_.tasks()) {
+      cr_confs_[task.name()] = task;
+      if (task.has_stack_size()) {
+        stack_sizes_[task.name()] = task.stack_size();
+      }
+    }
+  }
+
+  proc_num_ = edf_conf_.processor_num();
+  if (proc_num_ == 0) {
+    auto& global_conf = GlobalData::Instance()->Config();
+    if (global_conf.has_scheduler_conf() &&
+        global_conf.scheduler_conf().has_default_proc_num()) {
+      proc_num_ = global_conf.scheduler_conf().default_proc_num();
+    } else {
+      proc_num_ = 2;
+    }
+  }
+  task_pool_size_ = proc_num_;
+
+  CreateProcessor();
+}
+
+void SchedulerEdf::CreateProcessor() {
+  std::vector<int> cpuset;
+  ParseCpuset(edf_conf_.cpuset(), &cpuset);
+  auto affinity = edf_conf_.affinity();
+  if (affinity == "auto") {
+    cpuset = AutoAffinity("edf", cpuset, proc_num_);
+    affinity = "1to1";
+  }
+
+  for (uint32_t i = 0; i < proc_num_; i++) {
+    auto ctx = std::make_shared<EdfContext>(run_queue_);
+    ctx->SetIdleSpin(
+        std::chrono::microseconds(edf_conf_.processor_idle_spin_us()));
+    pctxs_.emplace_back(ctx);
+
+    auto proc = std::make_shared<Processor>();
+    proc->BindContext(ctx);
+    proc->SetSchedAffinity(cpuset, affinity, i);
+    proc->SetSchedPolicy(edf_conf_.processor_policy(),
+                         edf_conf_.processor_prio());
+    processors_.emplace_back(proc);
+  }
+}
+
+std::chrono::nanoseconds SchedulerEdf::RelativeDeadline(
+    const std::string& name) const {
+  uint64_t deadline_us = edf_conf_.default_deadline_us();
+  auto iter = cr_confs_.find(name);
+  if (iter != cr_confs_.end()) {
+    if (iter->second.has_deadline_us()) {
+      deadline_us = iter->second.deadline_us();
+    } else if (iter->second.has_period_us()) {
+      deadline_us = iter->second.period_us();
+    }
+  }
+  return std::chrono::microseconds(deadline_us);
+}
+
+bool SchedulerEdf::DispatchTask(const std::shared_ptr<CRoutine>& cr) {
+  // we use multi-key mutex to prevent race condition
+  // when del && add cr with same crid
+  auto crid = cr->id();
+  MutexWrapper wrapper;
+  {
+    std::lock_guard<std::mutex> wl_lg(cr_wl_mtx_);
+    auto iter = id_map_mutex_.find(crid);
+    if (iter != id_map_mutex_.end()) {
+      wrapper = iter->second;
+    } else {
+      wrapper = std::make_shared<std::mutex>();
+      id_map_mutex_.emplace(crid, wrapper);
+    }
+  }
+
+  std::lock_guard<std::mutex> lg(*wrapper);
+
+  auto task = std::make_shared<EdfTask>(cr, RelativeDeadline(cr->name()));
+  {
+    WriteLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    if (id_cr_.find(crid) != id_cr_.end()) {
+      return false;
+    }
+    id_cr_.emplace(crid, cr);
+    id_task_.emplace(crid, task);
+  }
+
+  run_queue_->Enqueue(task, EdfTask::Clock::now() + task->relative_deadline);
+  return true;
+}
+
+bool SchedulerEdf::NotifyProcessor(uint64_t crid) {
+  return NotifyTask(crid, EdfTask::Clock::time_point::max());
+}
+
+bool SchedulerEdf::NotifyTask(
+    uint64_t crid, const std::chrono::steady_clock::time_point& deadline) {
+  if (unlikely(stop_.load())) {
+    return true;
+  }
+
+  std::shared_ptr<EdfTask> task;
+  {
+    ReadLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    auto iter = id_task_.find(crid);
+    if (iter == id_task_.end()) {
+      return false;
+    }
+    task = iter->second;
+    if (task->cr->state() == RoutineState::DATA_WAIT ||
+        task->cr->state() == RoutineState::IO_WAIT) {
+      task->cr->SetUpdateFlag();
+    }
+  }
+
+  run_queue_->Enqueue(task,
+                      deadline != EdfTask::Clock::time_point::max()
+                          ? deadline
+                          : EdfTask::Clock::now() + task->relative_deadline);
+  return true;
+}
+
+std::unordered_map<std::string, DeadlineStats>
+SchedulerEdf::GetDeadlineStats() {
+  std::unordered_map<std::string, DeadlineStats> stats;
+  ReadLockGuard<AtomicRWLock> lk(id_cr_lock_);
+  for (auto& id_task : id_task_) {
+    auto& task = id_task.second;
+    auto& entry = stats[task->cr->name()];
+    entry.activations = task->activations.load();
+    entry.deadline_misses = task->deadline_misses.load();
+    entry.max_lateness_ns = task->max_lateness_ns.load();
+  }
+  return stats;
+}
+
+bool SchedulerEdf::RemoveTask(const std::string& name) {
+  if (unlikely(stop_.load())) {
+    return true;
+  }
+
+  auto crid = GlobalData::GenerateHashId(name);
+  return RemoveCRoutine(crid);
+}
+
+bool SchedulerEdf::RemoveCRoutine(uint64_t crid) {
+  // we use multi-key mutex to prevent race condition
+  // when del && add cr with same crid
+  MutexWrapper wrapper;
+  {
+    std::lock_guard<std::mutex> wl_lg(cr_wl_mtx_);
+    auto iter = id_map_mutex_.find(crid);
+    if (iter != id_map_mutex_.end()) {
+      wrapper = iter->second;
+    } else {
+      wrapper = std::make_shared<std::mutex>();
+      id_map_mutex_.emplace(crid, wrapper);
+    }
+  }
+
+  std::lock_guard<std::mutex> lg(*wrapper);
+
+  std::shared_ptr<EdfTask> task;
+  {
+    WriteLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    auto iter = id_task_.find(crid);
+    if (iter == id_task_.end()) {
+      return false;
+    }
+    task = iter->second;
+    id_task_.erase(iter);
+    id_cr_.erase(crid);
+  }
+
+  auto cr = task->cr;
+  cr->Stop();
+  while (!cr->Acquire()) {
+    std::this_thread::sleep_for(std::chrono::microseconds(1));
+    AINFO_EVERY(1000) << "waiting for task " << cr->name() << " completion";
+  }
+  cr->Release();
+
+  if (task->deadline_misses.load() > 0) {
+    AINFO << "task " << cr->name() << " missed "
+          << task->deadline_misses.load() << " of "
+          << task->activations.load() << " deadlines, late by up to "
+          << task->max_lateness_ns.load() / 1000 << "us";
+  }
+  return true;
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
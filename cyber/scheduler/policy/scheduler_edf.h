@@ -0,0 +1,81 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_POLICY_SCHEDULER_EDF_H_
+#define CYBER_SCHEDULER_POLICY_SCHEDULER_EDF_H_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "cyber/croutine/croutine.h"
+#include "cyber/proto/edf_conf.pb.h"
+#include "cyber/scheduler/policy/edf_context.h"
+#include "cyber/scheduler/scheduler.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::croutine::CRoutine;
+using apollo::cyber::proto::EdfConf;
+
+struct DeadlineStats {
+  uint64_t activations = 0;
+  uint64_t deadline_misses = 0;
+  int64_t max_lateness_ns = 0;
+};
+
+// Earliest deadline first. Every task has a relative deadline from the
+// edf_conf, each time it is woken its activation is due that much later
+// and the processors always run the ready task due first.
+class SchedulerEdf : public Scheduler {
+ public:
+  bool RemoveCRoutine(uint64_t crid) override;
+  bool RemoveTask(const std::string& name) override;
+  bool DispatchTask(const std::shared_ptr<CRoutine>&) override;
+
+  using Scheduler::NotifyTask;
+  // wakes the task due at |deadline| instead of its relative deadline
+  bool NotifyTask(uint64_t crid,
+                  const std::chrono::steady_clock::time_point& deadline);
+
+  // keyed by task name
+  std::unordered_map<std::string, DeadlineStats> GetDeadlineStats();
+
+ private:
+  friend Scheduler* Instance();
+  SchedulerEdf();
+
+  void CreateProcessor();
+  bool NotifyProcessor(uint64_t crid) override;
+  std::chrono::nanoseconds RelativeDeadline(const std::string& name) const;
+
+  std::unordered_map<std::string, proto::EdfTask> cr_confs_;
+  // under id_cr_lock_, like id_cr_
+  std::unordered_map<uint64_t, std::shared_ptr<EdfTask>> id_task_;
+  std::shared_ptr<EdfRunQueue> run_queue_;
+
+  EdfConf edf_conf_;
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_POLICY_SCHEDULER_EDF_H_
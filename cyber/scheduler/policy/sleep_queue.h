@@ -0,0 +1,99 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_POLICY_SLEEP_QUEUE_H_
+#define CYBER_SCHEDULER_POLICY_SLEEP_QUEUE_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+// Sleeping routines of one processor in a min-heap on their wake time, so
+// the processor only looks at the ones that are due and parks until the
+// earliest. Only its processor touches it, there is no lock.
+template <typename T>
+class SleepQueue {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  void Push(const Clock::time_point& wake_time, const T& item) {
+    heap_.push_back(Entry{wake_time, seq_++, item});
+    std::push_heap(heap_.begin(), heap_.end(), Later());
+  }
+
+  // Takes the earliest one if |now| is past its wake time.
+  bool PopDue(const Clock::time_point& now, T* item) {
+    if (heap_.empty() || !(now > heap_.front().wake_time)) {
+      return false;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), Later());
+    *item = std::move(heap_.back().item);
+    heap_.pop_back();
+    return true;
+  }
+
+  // Takes all for which |pred| returns true, whenever they are due.
+  template <typename Pred>
+  void TakeIf(const Pred& pred, std::vector<T>* taken) {
+    auto it = std::partition(heap_.begin(), heap_.end(),
+                             [&pred](const Entry& e) { return !pred(e.item); });
+    if (it == heap_.end()) {
+      return;
+    }
+    for (auto e = it; e != heap_.end(); ++e) {
+      taken->emplace_back(std::move(e->item));
+    }
+    heap_.erase(it, heap_.end());
+    std::make_heap(heap_.begin(), heap_.end(), Later());
+  }
+
+  // Clock::time_point::max() if nothing sleeps
+  Clock::time_point NextWake() const {
+    return heap_.empty() ? Clock::time_point::max() : heap_.front().wake_time;
+  }
+
+  bool Empty() const { return heap_.empty(); }
+  size_t size() const { return heap_.size(); }
+
+ private:
+  struct Entry {
+    Clock::time_point wake_time;
+    uint64_t seq;
+    T item;
+  };
+  // std::push_heap keeps the greatest on top, this makes it the earliest
+  struct Later {
+    bool operator()(const Entry& a, const Entry& b) const {
+      return a.wake_time != b.wake_time ? a.wake_time > b.wake_time
+                                        : a.seq > b.seq;
+    }
+  };
+
+  std::vector<Entry> heap_;
+  uint64_t seq_ = 0;
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_POLICY_SLEEP_QUEUE_H_
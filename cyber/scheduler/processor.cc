@@ -31,6 +31,16 @@ namespace scheduler {
 
 using apollo::cyber::common::GlobalData;
 
+namespace {
+
+uint64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
 Processor::Processor() { running_.exchange(true); }
 
 Processor::~Processor() { Stop(); }
@@ -83,15 +93,75 @@ void Processor::Run() {
     return;
   }
 
+  uint64_t idle_spin_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          context_->idle_spin())
+          .count();
+  bool busy_poll = context_->busy_poll();
+  bool spinning = false;
+  uint64_t spin_start = 0;
+  // the counters have a single writer
+  auto end_spin = [&](bool hit) {
+    spinning = false;
+    context_->EndSpin();
+    spin_start_ns_.store(0, std::memory_order_relaxed);
+    spin_ns_.store(spin_ns_.load(std::memory_order_relaxed) + NowNs() -
+                       spin_start,
+                   std::memory_order_relaxed);
+    if (hit) {
+      spin_hits_.store(spin_hits_.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+    }
+  };
+
   while (likely(running_.load())) {
     auto croutine = context_->NextRoutine();
     if (croutine) {
+      if (spinning) {
+        end_spin(true);
+      }
+      croutine->BeginRun(tid_.load(std::memory_order_relaxed));
       croutine->Resume();
+      croutine->EndRun();
       croutine->Release(); // Acquire() was done in NextRoutine().
-    } else {
-      context_->Wait();
+      continue;
     }
+
+    // poll a while before paying for a park and a wakeup
+    if (busy_poll || idle_spin_ns > 0) {
+      if (!spinning) {
+        spinning = true;
+        spin_start = NowNs();
+        spin_start_ns_.store(spin_start, std::memory_order_relaxed);
+        spins_.store(spins_.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
+        context_->BeginSpin();
+      }
+      if (busy_poll || NowNs() - spin_start < idle_spin_ns) {
+        cpu_relax();
+        continue;
+      }
+      end_spin(false);
+    }
+    context_->Wait();
+  }
+  if (spinning) {
+    end_spin(false);
+  }
+}
+
+ProcessorStats Processor::stats() const {
+  ProcessorStats stats;
+  stats.tid = tid_.load(std::memory_order_relaxed);
+  stats.spin_ns = spin_ns_.load(std::memory_order_relaxed);
+  // a busy polling processor may spin for good
+  auto spin_start_ns = spin_start_ns_.load(std::memory_order_relaxed);
+  if (spin_start_ns != 0) {
+    stats.spin_ns += NowNs() - spin_start_ns;
   }
+  stats.spins = spins_.load(std::memory_order_relaxed);
+  stats.spin_hits = spin_hits_.load(std::memory_order_relaxed);
+  return stats;
 }
 
 void Processor::Stop() {
@@ -35,6 +35,15 @@ namespace scheduler {
 
 using croutine::CRoutine;
 
+// How a processor spent its idle time polling, see
+// ProcessorContext::SetIdleSpin. Hits are the spins that found work.
+struct ProcessorStats {
+  int tid = -1;
+  uint64_t spin_ns = 0;
+  uint64_t spins = 0;
+  uint64_t spin_hits = 0;
+};
+
 class Processor {
  public:
   Processor();
@@ -44,6 +53,7 @@ class Processor {
   void BindContext(const std::shared_ptr<ProcessorContext>& context);
   void SetSchedAffinity(const std::vector<int>&, const std::string&, int);
   void SetSchedPolicy(const std::string& spolicy, int sched_priority);
+  ProcessorStats stats() const;
 
  private:
   void Run(); // LJM made Run() private.
@@ -54,6 +64,12 @@ class Processor {
 
   std::atomic<pid_t> tid_{-1};
   std::atomic<bool> running_{false};
+
+  std::atomic<uint64_t> spin_ns_{0};
+  std::atomic<uint64_t> spins_{0};
+  std::atomic<uint64_t> spin_hits_{0};
+  // steady clock time the current spin started, 0 for none
+  std::atomic<uint64_t> spin_start_ns_{0};
 };
 
 }  // namespace scheduler
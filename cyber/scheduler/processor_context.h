@@ -17,6 +17,8 @@
 #ifndef CYBER_SCHEDULER_POLICY_PROCESSOR_CONTEXT_H_
 #define CYBER_SCHEDULER_POLICY_PROCESSOR_CONTEXT_H_
 
+#include <atomic>
+#include <chrono>
 #include <limits>
 #include <memory>
 #include <mutex>
@@ -36,9 +38,26 @@ class ProcessorContext {
   virtual std::shared_ptr<CRoutine> NextRoutine() = 0;
   virtual void Wait() = 0;
 
+  // How the processor idles, see Processor::Run: it polls NextRoutine for
+  // |spin| before it parks in Wait(), with |busy_poll| it never parks.
+  void SetIdleSpin(std::chrono::microseconds spin, bool busy_poll = false) {
+    idle_spin_ = spin;
+    busy_poll_ = busy_poll;
+  }
+  std::chrono::microseconds idle_spin() const { return idle_spin_; }
+  bool busy_poll() const { return busy_poll_; }
+
+  // Bracket the polling, so that whoever queues work can leave it to the
+  // spinning processor instead of waking a parked one.
+  virtual void BeginSpin() {}
+  virtual void EndSpin() {}
+
  protected:
   std::atomic<bool> stop_ = { false };
-  alignas(CACHELINE_SIZE) std::atomic_flag notified_ = ATOMIC_FLAG_INIT;
+
+ private:
+  std::chrono::microseconds idle_spin_ = std::chrono::microseconds(0);
+  bool busy_poll_ = false;
 };
 
 }  // namespace scheduler
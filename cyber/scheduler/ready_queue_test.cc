@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/ready_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::croutine::RoutineState;
+
+std::shared_ptr<CRoutine> NewRoutine(uint64_t id) {
+  auto cr = CRoutine::CreateStackless([]() { return RoutineState::FINISHED; });
+  cr->set_id(id);
+  return cr;
+}
+
+TEST(ReadyQueueTest, fifo) {
+  ReadyQueue queue;
+  std::shared_ptr<CRoutine> cr;
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_FALSE(queue.Dequeue(&cr));
+
+  // twice the capacity, the second half overflows
+  const uint64_t num = 2 * ReadyQueue::kCapacity;
+  for (uint64_t i = 0; i < num; ++i) {
+    queue.Enqueue(NewRoutine(i));
+  }
+  EXPECT_FALSE(queue.Empty());
+  for (uint64_t i = 0; i < num; ++i) {
+    ASSERT_TRUE(queue.Dequeue(&cr));
+    EXPECT_EQ(i, cr->id());
+    // the queue lets go of its reference
+    EXPECT_EQ(1, cr.use_count());
+  }
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_FALSE(queue.Dequeue(&cr));
+}
+
+TEST(ReadyQueueTest, requeue) {
+  // more routines than cells that stay ready, each requeued once it ran
+  ReadyQueue queue;
+  const uint64_t num = 2 * ReadyQueue::kCapacity + 10;
+  for (uint64_t i = 0; i < num; ++i) {
+    queue.Enqueue(NewRoutine(i));
+  }
+  std::shared_ptr<CRoutine> cr;
+  for (uint64_t i = 0; i < 3 * num; ++i) {
+    ASSERT_TRUE(queue.Dequeue(&cr));
+    // the overflowed ones take their turn, in the order they came
+    EXPECT_EQ(i % num, cr->id());
+    queue.Enqueue(cr);
+  }
+}
+
+TEST(ReadyQueueTest, concurrent) {
+  ReadyQueue queue;
+  const int producers = 4;
+  const uint64_t per_producer = 100000;
+  std::vector<std::shared_ptr<CRoutine>> routines;
+  for (uint64_t i = 0; i < 64; ++i) {
+    routines.emplace_back(NewRoutine(i));
+  }
+
+  std::atomic<uint64_t> consumed = {0};
+  std::atomic<uint64_t> sum = {0};
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&]() {
+      for (uint64_t i = 0; i < per_producer; ++i) {
+        queue.Enqueue(routines[i % routines.size()]);
+      }
+    });
+    threads.emplace_back([&]() {
+      std::shared_ptr<CRoutine> cr;
+      while (consumed.load() < producers * per_producer) {
+        if (queue.Dequeue(&cr)) {
+          sum.fetch_add(cr->id());
+          consumed.fetch_add(1);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  uint64_t expected = 0;
+  for (uint64_t i = 0; i < per_producer; ++i) {
+    expected += i % routines.size();
+  }
+  EXPECT_EQ(producers * per_producer, consumed.load());
+  EXPECT_EQ(producers * expected, sum.load());
+  EXPECT_TRUE(queue.Empty());
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,90 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/rebalancer.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+TaskLoad Task(const std::string& name, const std::string& group,
+              uint64_t busy_ns, const std::vector<std::string>& groups) {
+  TaskLoad task;
+  task.name = name;
+  task.group = group;
+  task.busy_ns = busy_ns;
+  task.groups = groups;
+  return task;
+}
+
+TEST(RebalancerTest, plan) {
+  RebalanceConf conf;
+  conf.set_max_migrations(2);
+  std::unordered_map<std::string, GroupLoad> groups;
+  // 2 processors each over 100ms
+  groups["busy"].busy_ns = 195;
+  groups["busy"].capacity_ns = 200;
+  groups["idle"].busy_ns = 20;
+  groups["idle"].capacity_ns = 200;
+  groups["half"].busy_ns = 110;
+  groups["half"].capacity_ns = 200;
+
+  // the busiest movable task goes to the least loaded group it may use
+  auto migrations = PlanMigrations(
+      conf, groups,
+      {Task("pinned", "busy", 100, {}), Task("small", "busy", 10, {"idle"}),
+       Task("perception", "busy", 60, {"busy", "half", "idle"})});
+  ASSERT_EQ(1, migrations.size());
+  EXPECT_EQ("perception", migrations[0].name);
+  EXPECT_EQ("idle", migrations[0].group);
+
+  // moving it would saturate the target
+  migrations = PlanMigrations(
+      conf, groups, {Task("perception", "busy", 180, {"half", "idle"})});
+  EXPECT_TRUE(migrations.empty());
+
+  // a group below high_load keeps its tasks
+  groups["busy"].busy_ns = 170;
+  migrations = PlanMigrations(
+      conf, groups, {Task("perception", "busy", 60, {"half", "idle"})});
+  EXPECT_TRUE(migrations.empty());
+
+  // sheds until below high_load, one move per round by default
+  groups["busy"].busy_ns = 200;
+  std::vector<TaskLoad> tasks = {Task("a", "busy", 10, {"idle"}),
+                                 Task("b", "busy", 10, {"idle"}),
+                                 Task("c", "busy", 10, {"idle"})};
+  migrations = PlanMigrations(conf, groups, tasks);
+  ASSERT_EQ(2, migrations.size());
+  EXPECT_EQ("a", migrations[0].name);
+  EXPECT_EQ("b", migrations[1].name);
+  migrations = PlanMigrations(RebalanceConf(), groups, tasks);
+  EXPECT_EQ(1, migrations.size());
+  groups["busy"].busy_ns = 185;
+  migrations = PlanMigrations(conf, groups, tasks);
+  ASSERT_EQ(1, migrations.size());
+  EXPECT_EQ("a", migrations[0].name);
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
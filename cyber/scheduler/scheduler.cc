@@ -17,14 +17,18 @@
 #include "cyber/scheduler/scheduler.h"
 
 #include <sched.h>
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "cyber/common/environment.h"
 #include "cyber/common/file.h"
 #include "cyber/common/global_data.h"
 #include "cyber/common/util.h"
+#include "cyber/croutine/stack_watermark.h"
 #include "cyber/data/data_visitor.h"
 #include "cyber/event/perf_event_cache.h"
+#include "cyber/scheduler/cpu_topology.h"
 #include "cyber/scheduler/processor.h"
 #include "cyber/scheduler/processor_context.h"
 
@@ -33,9 +37,14 @@ namespace cyber {
 namespace scheduler {
 
 using apollo::cyber::common::GlobalData;
+using apollo::cyber::croutine::StackWatermark;
 
 bool Scheduler::CreateTask(const RoutineFactory& factory,
                            const std::string& name) {
+  if (factory.create_step) {
+    return CreateStacklessTask(factory.create_step(), name,
+                               factory.GetDataVisitor());
+  }
   return CreateTask(factory.create_routine(), name, factory.GetDataVisitor());
 }
 
@@ -49,18 +58,48 @@ bool Scheduler::CreateTask(std::function<void()>&& func,
 
   auto task_id = GlobalData::RegisterTaskName(name);
 
-  auto cr = std::make_shared<CRoutine>(func);
+  size_t stack_size = 0;
+  auto iter = stack_sizes_.find(name);
+  if (iter != stack_sizes_.end()) {
+    stack_size = iter->second;
+  }
+  auto cr = std::make_shared<CRoutine>(func, stack_size);
   cr->set_id(task_id);
   cr->set_name(name);
   AINFO << "create croutine: " << name;
+  return StartTask(cr, visitor);
+}
+
+bool Scheduler::CreateStacklessTask(StepFunc&& step, const std::string& name,
+                                    std::shared_ptr<DataVisitorBase> visitor) {
+  if (unlikely(stop_.load())) {
+    ADEBUG << "scheduler is stopped, cannot create task!";
+    return false;
+  }
+
+  auto task_id = GlobalData::RegisterTaskName(name);
+
+  auto cr = CRoutine::CreateStackless(step);
+  cr->set_id(task_id);
+  cr->set_name(name);
+  AINFO << "create stackless croutine: " << name;
+  return StartTask(cr, visitor);
+}
 
+bool Scheduler::StartTask(const std::shared_ptr<CRoutine>& cr,
+                          std::shared_ptr<DataVisitorBase> visitor) {
   if (!DispatchTask(cr)) {
     return false;
   }
 
   if (visitor != nullptr) {
-    visitor->RegisterNotifyCallback([this, task_id]() {
-      this->NotifyTask(task_id);
+    // Resolved once, a message wakes the routine without looking it up. Held
+    // weakly, the routine's function may own the visitor.
+    std::weak_ptr<CRoutine> routine = cr;
+    visitor->RegisterNotifyCallback([this, routine]() {
+      if (auto cr = routine.lock()) {
+        this->NotifyTask(cr);
+      }
     });
   }
   return true;
@@ -73,6 +112,26 @@ bool Scheduler::NotifyTask(uint64_t crid) {
   return NotifyProcessor(crid);
 }
 
+bool Scheduler::NotifyTask(const std::shared_ptr<CRoutine>& cr) {
+  if (unlikely(stop_.load())) {
+    return true;
+  }
+  return NotifyRoutine(cr);
+}
+
+bool Scheduler::MigrateTask(const std::string& name,
+                            const std::string& group) {
+  AWARN << "cannot move task " << name << " to group " << group
+        << ", the scheduler policy has no groups.";
+  return false;
+}
+
+bool Scheduler::MigrateTask(const std::string& name, int processor) {
+  AWARN << "cannot move task " << name << " to processor " << processor
+        << ", the scheduler policy does not pin tasks.";
+  return false;
+}
+
 void Scheduler::ParseCpuset(const std::string& str, std::vector<int>* cpuset) {
   std::vector<std::string> lines;
   std::stringstream ss(str);
@@ -102,6 +161,27 @@ void Scheduler::ParseCpuset(const std::string& str, std::vector<int>* cpuset) {
   }
 }
 
+std::vector<int> Scheduler::AutoAffinity(const std::string& name,
+                                         const std::vector<int>& cpuset,
+                                         uint32_t num) {
+  if (cpu_placer_ == nullptr) {
+    cpu_placer_ = std::make_shared<CpuPlacer>(CpuTopology::Read());
+  }
+  auto allowed = cpuset;
+  if (allowed.empty()) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+      for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) {
+          allowed.push_back(cpu);
+        }
+      }
+    }
+  }
+  return cpu_placer_->Place(name, num, allowed);
+}
+
 void Scheduler::ProcessLevelResourceControl() {
   std::vector<int> cpus;
   ParseCpuset(process_level_cpuset_, &cpus);
@@ -149,11 +229,77 @@ void Scheduler::SetInnerThreadAttr(const std::string& name, std::thread* thr) {
   pthread_setschedparam(thr->native_handle(), p, &sp);
 }
 
+void Scheduler::ReportStackUsage() {
+  auto watermark = StackWatermark::Instance();
+  if (!watermark->enabled()) {
+    AINFO << "stack watermark is disabled, set cyber_stack_watermark=1";
+    return;
+  }
+  {
+    ReadLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    for (auto& cr : id_cr_) {
+      cr.second->RecordStackUsage();
+    }
+  }
+  watermark->Report();
+}
+
+std::unordered_map<std::string, RoutineStats> Scheduler::GetRoutineStats() {
+  std::unordered_map<std::string, RoutineStats> stats;
+  ReadLockGuard<AtomicRWLock> lk(id_cr_lock_);
+  for (auto& cr : id_cr_) {
+    stats[cr.second->name()] = cr.second->stats();
+  }
+  return stats;
+}
+
+void Scheduler::ReportRoutineStats() {
+  auto stats = GetRoutineStats();
+  std::vector<std::pair<std::string, RoutineStats>> tasks(stats.begin(),
+                                                          stats.end());
+  std::sort(tasks.begin(), tasks.end(), [](const auto& a, const auto& b) {
+    return a.second.total_run_ns > b.second.total_run_ns;
+  });
+  for (auto& task : tasks) {
+    auto& s = task.second;
+    AINFO << "croutine[" << task.first << "] activations[" << s.activations
+          << "] run_us[total " << s.total_run_ns / 1000 << " avg "
+          << (s.activations ? s.total_run_ns / s.activations / 1000 : 0)
+          << " max " << s.max_run_ns / 1000 << "] wake_latency_us[avg "
+          << (s.wakeups ? s.total_wake_latency_ns / s.wakeups / 1000 : 0)
+          << " max " << s.max_wake_latency_ns / 1000 << "] last_processor["
+          << s.last_processor << "]";
+  }
+}
+
+std::vector<ProcessorStats> Scheduler::GetProcessorStats() {
+  std::vector<ProcessorStats> stats;
+  for (auto& processor : processors_) {
+    stats.emplace_back(processor->stats());
+  }
+  return stats;
+}
+
+void Scheduler::ReportProcessorStats() {
+  for (auto& s : GetProcessorStats()) {
+    if (s.spins == 0) {
+      continue;
+    }
+    AINFO << "processor[" << s.tid << "] idle_spin_ms["
+          << s.spin_ns / 1000000 << "] spins[" << s.spins << "] hits["
+          << s.spin_hits << "]";
+  }
+}
+
 void Scheduler::Shutdown() {
   if (unlikely(stop_.exchange(true))) {
     return;
   }
 
+  if (StackWatermark::Instance()->enabled()) {
+    ReportStackUsage();
+  }
+
   for (auto& ctx : pctxs_) {
     ctx->Shutdown();
   }
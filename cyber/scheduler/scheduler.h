@@ -46,11 +46,15 @@ using apollo::cyber::base::AtomicRWLock;
 using apollo::cyber::base::ReadLockGuard;
 using apollo::cyber::croutine::CRoutine;
 using apollo::cyber::croutine::RoutineFactory;
+using apollo::cyber::croutine::RoutineStats;
+using apollo::cyber::croutine::StepFunc;
 using apollo::cyber::data::DataVisitorBase;
 using apollo::cyber::proto::InnerThread;
 
+class CpuPlacer;
 class Processor;
 class ProcessorContext;
+struct ProcessorStats;
 
 using MutexWrapper = std::shared_ptr<std::mutex>;
 
@@ -62,18 +66,43 @@ class Scheduler {
   bool CreateTask(const RoutineFactory& factory, const std::string& name);
   bool CreateTask(std::function<void()>&& func, const std::string& name,
                   std::shared_ptr<DataVisitorBase> visitor = nullptr);
+  // the task runs as a stackless croutine, see CRoutine::CreateStackless
+  bool CreateStacklessTask(StepFunc&& step, const std::string& name,
+                           std::shared_ptr<DataVisitorBase> visitor = nullptr);
   bool NotifyTask(uint64_t crid);
+  // NotifyTask(cr->id()) for a routine already at hand, no lookup by id
+  bool NotifyTask(const std::shared_ptr<CRoutine>& cr);
 
   void Shutdown();
+  // logs the stack high water mark of every task, see StackWatermark
+  void ReportStackUsage();
+  // runtime accounting of every task by name, see RoutineStats
+  std::unordered_map<std::string, RoutineStats> GetRoutineStats();
+  // logs GetRoutineStats(), the busiest tasks first
+  void ReportRoutineStats();
+  // idle polling of every processor, see ProcessorContext::SetIdleSpin
+  std::vector<ProcessorStats> GetProcessorStats();
+  void ReportProcessorStats();
   uint32_t TaskPoolSize() const { return task_pool_size_; }
 
   virtual bool RemoveTask(const std::string& name) = 0;
 
+  // Moves a live task to another classic group or choreography processor,
+  // it keeps its state and its pending notifications. False if the policy
+  // has no such target.
+  virtual bool MigrateTask(const std::string& name, const std::string& group);
+  virtual bool MigrateTask(const std::string& name, int processor);
+
   void ProcessLevelResourceControl();
   void SetInnerThreadAttr(const std::string& name, std::thread* thr);
 
   virtual bool DispatchTask(const std::shared_ptr<CRoutine>&) = 0;
   virtual bool NotifyProcessor(uint64_t crid) = 0;
+  // Policies that can queue |cr| as is override it, by default it is looked
+  // up by id like any other notification.
+  virtual bool NotifyRoutine(const std::shared_ptr<CRoutine>& cr) {
+    return NotifyProcessor(cr->id());
+  }
   virtual bool RemoveCRoutine(uint64_t crid) = 0;
 
   void SetInnerThreadConfs(const std::unordered_map<std::string, InnerThread>& confs) {
@@ -82,7 +111,14 @@ class Scheduler {
 
  protected:
   Scheduler() : stop_(false) {}
+  bool StartTask(const std::shared_ptr<CRoutine>& cr,
+                 std::shared_ptr<DataVisitorBase> visitor);
   void ParseCpuset(const std::string&, std::vector<int>*);
+  // Cpus for the |num| processors of |name| under affinity "auto", one per
+  // processor out of |cpuset|, or out of the process' cpus if that is
+  // empty. Empty if the topology is unknown, see CpuPlacer.
+  std::vector<int> AutoAffinity(const std::string& name,
+                                const std::vector<int>& cpuset, uint32_t num);
 
   std::mutex cr_wl_mtx_;
   std::unordered_map<uint64_t, MutexWrapper> id_map_mutex_;
@@ -93,6 +129,10 @@ class Scheduler {
   std::vector<std::shared_ptr<Processor>> processors_;
 
   std::unordered_map<std::string, InnerThread> inner_thr_confs_;
+  // croutine stack size of the tasks configuring one
+  std::unordered_map<std::string, size_t> stack_sizes_;
+  // read on the first AutoAffinity, remembers what it handed out
+  std::shared_ptr<CpuPlacer> cpu_placer_;
 
   std::string process_level_cpuset_;
   uint32_t proc_num_ = 0;
@@ -16,6 +16,10 @@
 
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
 
 #include "cyber/common/global_data.h"
 // #include "cyber/cyber.h"
@@ -47,6 +51,36 @@ TEST(SchedulerChoreoTest, choreo) {
   ctx->Shutdown();
 }
 
+bool WaitFor(const std::function<bool()>& condition) {
+  for (int i = 0; i < 1000 && !condition(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return condition();
+}
+
+TEST(SchedulerChoreoTest, event_driven) {
+  auto processor = std::make_shared<Processor>();
+  auto ctx = std::make_shared<ChoreographyContext>();
+  processor->BindContext(ctx);
+
+  std::atomic<int> runs = {0};
+  auto cr = CRoutine::CreateStackless([&runs]() {
+    runs++;
+    return croutine::RoutineState::DATA_WAIT;
+  });
+  cr->set_id(GlobalData::RegisterTaskName("choreo_event"));
+  ctx->Enqueue(cr);
+  EXPECT_TRUE(WaitFor([&runs]() { return runs.load() == 1; }));
+
+  // parked until notified
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(1, runs.load());
+  cr->SetUpdateFlag();
+  ctx->Notify();
+  EXPECT_TRUE(WaitFor([&runs]() { return runs.load() == 2; }));
+  processor->Stop();
+}
+
 TEST(SchedulerChoreoTest, sched_choreo) {
   GlobalData::Instance()->SetProcessGroup("example_sched_choreography");
   auto sched = dynamic_cast<SchedulerChoreography*>(scheduler::Instance());
@@ -85,6 +119,31 @@ TEST(SchedulerChoreoTest, sched_choreo) {
   EXPECT_EQ(itr, cr_names.end());
 }
 
+TEST(SchedulerChoreoTest, migrate_task) {
+  auto sched = dynamic_cast<SchedulerChoreography*>(scheduler::Instance());
+  std::atomic<int> runs = {0};
+  auto cr = CRoutine::CreateStackless([&runs]() {
+    runs++;
+    return croutine::RoutineState::DATA_WAIT;
+  });
+  std::string name = "choreo_migrate";
+  cr->set_id(GlobalData::RegisterTaskName(name));
+  cr->set_name(name);
+  cr->set_processor_id(0);
+  EXPECT_TRUE(sched->DispatchTask(cr));
+  EXPECT_TRUE(WaitFor([&runs]() { return runs.load() == 1; }));
+
+  // 8 choreography processors, no groups
+  EXPECT_FALSE(sched->MigrateTask(name, 8));
+  EXPECT_FALSE(sched->MigrateTask(name, DEFAULT_GROUP_NAME));
+  EXPECT_TRUE(sched->MigrateTask(name, 1));
+  EXPECT_EQ(1, cr->processor_id());
+
+  EXPECT_TRUE(sched->NotifyTask(cr->id()));
+  EXPECT_TRUE(WaitFor([&runs]() { return runs.load() == 2; }));
+  EXPECT_TRUE(sched->RemoveTask(name));
+}
+
 }  // namespace scheduler
 }  // namespace cyber
 }  // namespace apollo
@@ -30,6 +30,8 @@ namespace apollo {
 namespace cyber {
 namespace scheduler {
 
+using apollo::cyber::croutine::RoutineState;
+
 void Init(const char* program) { SetState(STATE_INITIALIZED); }
 void func() {}
 
@@ -61,6 +63,284 @@ TEST(SchedulerClassicTest, classic) {
   processor->Stop();
 }
 
+TEST(SchedulerClassicTest, ready_queue) {
+  auto ctx = std::make_shared<ClassicContext>("ready_queue_grp");
+  int runs = 0;
+  auto step = [&runs]() {
+    ++runs;
+    return RoutineState::DATA_WAIT;
+  };
+  std::vector<std::shared_ptr<CRoutine>> crs;
+  for (int i = 0; i < 3; ++i) {
+    auto cr = CRoutine::CreateStackless(step);
+    cr->set_id(i);
+    cr->set_priority(i);
+    cr->set_group_name("ready_queue_grp");
+    crs.emplace_back(cr);
+  }
+  EXPECT_EQ(nullptr, ctx->NextRoutine());
+
+  // the higher priority first, a routine is queued once
+  ClassicContext::Enqueue(crs[0]);
+  ClassicContext::Enqueue(crs[2]);
+  ClassicContext::Enqueue(crs[2]);
+  for (int i : {2, 0}) {
+    auto cr = ctx->NextRoutine();
+    ASSERT_EQ(crs[i], cr);
+    EXPECT_EQ(RoutineState::DATA_WAIT, cr->Resume());
+    cr->Release();
+  }
+  EXPECT_EQ(nullptr, ctx->NextRoutine());
+  EXPECT_EQ(2, runs);
+
+  // waiting routines come back on a notification only
+  crs[1]->set_state(RoutineState::DATA_WAIT);
+  crs[1]->SetUpdateFlag();
+  ClassicContext::Enqueue(crs[1]);
+  auto cr = ctx->NextRoutine();
+  ASSERT_EQ(crs[1], cr);
+  cr->Resume();
+  // notified while running, it is put back right after
+  cr->SetUpdateFlag();
+  ClassicContext::Enqueue(cr);
+  cr->Release();
+  EXPECT_EQ(crs[1], ctx->NextRoutine());
+  crs[1]->Resume();
+  crs[1]->Release();
+  EXPECT_EQ(nullptr, ctx->NextRoutine());
+  EXPECT_EQ(4, runs);
+  ctx->Shutdown();
+}
+
+TEST(SchedulerClassicTest, work_stealing) {
+  auto ctx0 = std::make_shared<ClassicContext>("steal_grp", true);
+  auto ctx1 = std::make_shared<ClassicContext>("steal_grp", true);
+  auto cr = CRoutine::CreateStackless([]() { return RoutineState::DATA_WAIT; });
+  cr->set_group_name("steal_grp");
+
+  // dispatched to the shared queues, anyone takes it
+  ClassicContext::Enqueue(cr);
+  ASSERT_EQ(cr, ctx0->NextRoutine());
+  cr->Resume();
+  cr->Release();
+  EXPECT_EQ(nullptr, ctx0->NextRoutine());
+
+  // woken up again, it goes to the local queue of ctx0
+  cr->SetUpdateFlag();
+  ClassicContext::Enqueue(cr);
+  ASSERT_EQ(cr, ctx0->NextRoutine());
+  cr->Resume();
+  cr->Release();
+  EXPECT_EQ(nullptr, ctx0->NextRoutine());
+
+  // ctx1 steals it while ctx0 is busy
+  cr->SetUpdateFlag();
+  ClassicContext::Enqueue(cr);
+  ASSERT_EQ(cr, ctx1->NextRoutine());
+  cr->Resume();
+  cr->Release();
+  EXPECT_EQ(nullptr, ctx1->NextRoutine());
+
+  // now it sticks to ctx1
+  cr->SetUpdateFlag();
+  ClassicContext::Enqueue(cr);
+  ASSERT_EQ(cr, ctx1->NextRoutine());
+  cr->Resume();
+  cr->Release();
+  EXPECT_EQ(nullptr, ctx1->NextRoutine());
+
+  // one that never ran is not starved by the local queue
+  auto fresh =
+      CRoutine::CreateStackless([]() { return RoutineState::DATA_WAIT; });
+  fresh->set_group_name("steal_grp");
+  cr->SetUpdateFlag();
+  ClassicContext::Enqueue(cr);
+  ClassicContext::Enqueue(fresh);
+  ASSERT_EQ(fresh, ctx1->NextRoutine());
+  fresh->Resume();
+  fresh->Release();
+  ASSERT_EQ(cr, ctx1->NextRoutine());
+  cr->Resume();
+  cr->Release();
+  EXPECT_EQ(nullptr, ctx1->NextRoutine());
+  ctx0->Shutdown();
+  ctx1->Shutdown();
+}
+
+TEST(SchedulerClassicTest, migrate) {
+  auto from = std::make_shared<ClassicContext>("migrate_from");
+  auto to = std::make_shared<ClassicContext>("migrate_to");
+  auto never = []() { return false; };
+  auto cr = CRoutine::CreateStackless([]() { return RoutineState::READY; });
+  cr->set_group_name("migrate_from");
+
+  // queued and running in the old group, it is handed over on its requeue
+  ClassicContext::Enqueue(cr);
+  std::atomic<bool> moved = {false};
+  std::thread migrator([&]() {
+    EXPECT_TRUE(ClassicContext::Migrate(cr, "migrate_to", never));
+    moved.store(true);
+  });
+  while (!moved.load()) {
+    auto running = from->NextRoutine();
+    if (running != nullptr) {
+      running->Resume();
+      running->Release();
+    }
+  }
+  migrator.join();
+  EXPECT_EQ("migrate_to", cr->group_name());
+  EXPECT_EQ(nullptr, from->NextRoutine());
+  ASSERT_EQ(cr, to->NextRoutine());
+  cr->Resume();
+  cr->Release();
+
+  // cancelled, it stays where it is
+  EXPECT_FALSE(
+      ClassicContext::Migrate(cr, "migrate_from", []() { return true; }));
+  EXPECT_FALSE(cr->migrating());
+  ASSERT_EQ(cr, to->NextRoutine());
+  cr->set_state(RoutineState::DATA_WAIT);
+  cr->Release();
+  EXPECT_EQ(nullptr, to->NextRoutine());
+
+  // waiting, it moves at once and waits on in the new group
+  EXPECT_TRUE(ClassicContext::Migrate(cr, "migrate_from", never));
+  EXPECT_EQ(nullptr, to->NextRoutine());
+  EXPECT_EQ(nullptr, from->NextRoutine());
+  cr->SetUpdateFlag();
+  ClassicContext::Enqueue(cr);
+  EXPECT_EQ(cr, from->NextRoutine());
+  cr->set_state(RoutineState::DATA_WAIT);
+  cr->Release();
+
+  // sleeping, it is handed over long before it is due
+  auto sleeper = CRoutine::CreateStackless([]() {
+    CRoutine::GetCurrentRoutine()->Sleep(std::chrono::seconds(10));
+    return RoutineState::SLEEP;
+  });
+  sleeper->set_group_name("migrate_from");
+  ClassicContext::Enqueue(sleeper);
+  ASSERT_EQ(sleeper, from->NextRoutine());
+  sleeper->Resume();
+  sleeper->Release();
+  EXPECT_EQ(nullptr, from->NextRoutine());
+  moved.store(false);
+  std::thread sleeper_migrator([&]() {
+    EXPECT_TRUE(ClassicContext::Migrate(sleeper, "migrate_to", never));
+    moved.store(true);
+  });
+  while (!moved.load()) {
+    EXPECT_EQ(nullptr, from->NextRoutine());
+  }
+  sleeper_migrator.join();
+  EXPECT_EQ("migrate_to", sleeper->group_name());
+  from->Shutdown();
+  to->Shutdown();
+}
+
+TEST(SchedulerClassicTest, sleep) {
+  auto ctx = std::make_shared<ClassicContext>("sleep_grp");
+  std::vector<int> woken;
+  std::vector<std::shared_ptr<CRoutine>> routines;
+  for (int ms : {30, 10, 20}) {
+    auto slept = std::make_shared<bool>(false);
+    auto cr = CRoutine::CreateStackless([ms, slept, &woken]() {
+      if (!*slept) {
+        *slept = true;
+        CRoutine::GetCurrentRoutine()->Sleep(
+            std::chrono::milliseconds(ms));
+        return RoutineState::SLEEP;
+      }
+      woken.push_back(ms);
+      return RoutineState::FINISHED;
+    });
+    cr->set_group_name("sleep_grp");
+    ClassicContext::Enqueue(cr);
+    routines.push_back(cr);
+  }
+
+  // parks until the earliest is due and wakes them in that order
+  auto start = std::chrono::steady_clock::now();
+  while (woken.size() < routines.size()) {
+    auto cr = ctx->NextRoutine();
+    if (cr == nullptr) {
+      ctx->Wait();
+      continue;
+    }
+    cr->Resume();
+    cr->Release();
+  }
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(30));
+  EXPECT_EQ(std::vector<int>({10, 20, 30}), woken);
+  ctx->Shutdown();
+}
+
+TEST(SchedulerClassicTest, unknown_group) {
+  auto cr = CRoutine::CreateStackless([]() { return RoutineState::READY; });
+  cr->set_group_name("late_grp");
+  // no processor of the group yet, the routine is not queued anywhere
+  ClassicContext::Enqueue(cr);
+  EXPECT_EQ(nullptr, cr->group());
+  EXPECT_FALSE(ClassicContext::Migrate(cr, "late_grp", []() { return false; }));
+
+  auto ctx = std::make_shared<ClassicContext>("late_grp");
+  ClassicContext::Enqueue(cr);
+  EXPECT_NE(nullptr, cr->group());
+  EXPECT_EQ(cr, ctx->NextRoutine());
+  cr->Release();
+  ctx->Shutdown();
+}
+
+TEST(SchedulerClassicTest, idle_spin) {
+  auto ctx = std::make_shared<ClassicContext>("spin_grp");
+  ctx->SetIdleSpin(std::chrono::milliseconds(200));
+  auto processor = std::make_shared<Processor>();
+  processor->BindContext(ctx);
+  std::atomic<int> runs = {0};
+  auto cr = CRoutine::CreateStackless([&runs]() {
+    ++runs;
+    return RoutineState::DATA_WAIT;
+  });
+  cr->set_group_name("spin_grp");
+  auto wait_runs = [&runs](int n) {
+    for (int i = 0; i < 1000 && runs.load() < n; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return runs.load();
+  };
+  ClassicContext::Enqueue(cr);
+  EXPECT_EQ(1, wait_runs(1));
+
+  // notified while the processor polls, it picks it up by itself
+  cr->SetUpdateFlag();
+  ClassicContext::Enqueue(cr);
+  EXPECT_EQ(2, wait_runs(2));
+  auto stats = processor->stats();
+  EXPECT_GE(stats.spins, 2);
+  EXPECT_GE(stats.spin_hits, 1);
+
+  // parks once the spin is over
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  auto spin_ns = processor->stats().spin_ns;
+  EXPECT_GE(spin_ns, 200000000);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(spin_ns, processor->stats().spin_ns);
+  processor->Stop();
+
+  // a busy polling one never does
+  auto busy = std::make_shared<ClassicContext>("busy_poll_grp");
+  busy->SetIdleSpin(std::chrono::microseconds(0), true);
+  processor = std::make_shared<Processor>();
+  processor->BindContext(busy);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  stats = processor->stats();
+  EXPECT_EQ(1, stats.spins);
+  EXPECT_GT(stats.spin_ns, 0);
+  processor->Stop();
+}
+
 TEST(SchedulerClassicTest, sched_classic) {
   // read example_sched_classic.conf
   GlobalData::Instance()->SetProcessGroup("example_sched_classic");
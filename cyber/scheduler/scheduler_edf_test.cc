@@ -0,0 +1,168 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "cyber/common/global_data.h"
+#include "cyber/scheduler/policy/edf_context.h"
+#include "cyber/scheduler/policy/scheduler_edf.h"
+#include "cyber/scheduler/scheduler_factory.h"
+#include "cyber/state.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::common::GlobalData;
+using apollo::cyber::croutine::RoutineState;
+using Clock = std::chrono::steady_clock;
+
+bool WaitFor(const std::function<bool()>& condition) {
+  for (int i = 0; i < 1000 && !condition(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return condition();
+}
+
+TEST(SchedulerEdfTest, earliest_deadline_first) {
+  auto run_queue = std::make_shared<EdfRunQueue>();
+  EdfContext ctx(run_queue);
+
+  std::vector<std::shared_ptr<EdfTask>> tasks;
+  for (uint64_t i = 0; i < 3; ++i) {
+    auto cr = CRoutine::CreateStackless([]() {
+      return RoutineState::DATA_WAIT;
+    });
+    cr->set_id(i);
+    tasks.emplace_back(
+        std::make_shared<EdfTask>(cr, std::chrono::milliseconds(100)));
+  }
+  auto now = Clock::now();
+  run_queue->Enqueue(tasks[0], now + std::chrono::seconds(3));
+  run_queue->Enqueue(tasks[1], now + std::chrono::seconds(1));
+  run_queue->Enqueue(tasks[2], now + std::chrono::seconds(2));
+  // queued already, the first deadline stands
+  run_queue->Enqueue(tasks[0], now);
+
+  for (uint64_t id : {1, 2, 0}) {
+    auto cr = ctx.NextRoutine();
+    ASSERT_NE(nullptr, cr);
+    EXPECT_EQ(id, cr->id());
+    cr->Resume();
+    cr->Release();
+  }
+  EXPECT_EQ(nullptr, ctx.NextRoutine());
+  EXPECT_TRUE(run_queue->Empty());
+  for (auto& task : tasks) {
+    EXPECT_EQ(1, task->activations.load());
+    EXPECT_EQ(0, task->deadline_misses.load());
+  }
+
+  // woken again with a deadline passed already
+  tasks[0]->cr->SetUpdateFlag();
+  run_queue->Enqueue(tasks[0], now);
+  auto cr = ctx.NextRoutine();
+  ASSERT_EQ(tasks[0]->cr, cr);
+  cr->Resume();
+  cr->Release();
+  EXPECT_EQ(nullptr, ctx.NextRoutine());
+  EXPECT_EQ(2, tasks[0]->activations.load());
+  EXPECT_EQ(1, tasks[0]->deadline_misses.load());
+  EXPECT_GT(tasks[0]->max_lateness_ns.load(), 0);
+
+  // notified while it runs, the next activation is due when asked for
+  auto task = tasks[1];
+  task->cr->SetUpdateFlag();
+  run_queue->Enqueue(task, now + std::chrono::seconds(5));
+  cr = ctx.NextRoutine();
+  ASSERT_EQ(task->cr, cr);
+  task->cr->SetUpdateFlag();
+  run_queue->Enqueue(task, now + std::chrono::seconds(4));
+  cr->Resume();
+  cr->Release();
+  cr = ctx.NextRoutine();
+  ASSERT_EQ(task->cr, cr);
+  EXPECT_EQ(2, task->activations.load());
+  EXPECT_TRUE(now + std::chrono::seconds(4) == task->deadline);
+  cr->Resume();
+  cr->Release();
+  EXPECT_EQ(nullptr, ctx.NextRoutine());
+  EXPECT_EQ(3, task->activations.load());
+
+  // notified twice while queued, one activation serves both and the
+  // deadline of the second does not carry over to the next activation
+  task = tasks[2];
+  task->cr->SetUpdateFlag();
+  run_queue->Enqueue(task, now + std::chrono::seconds(5));
+  task->cr->SetUpdateFlag();
+  run_queue->Enqueue(task, now + std::chrono::seconds(1));
+  cr = ctx.NextRoutine();
+  ASSERT_EQ(task->cr, cr);
+  EXPECT_TRUE(now + std::chrono::seconds(5) == task->deadline);
+  task->cr->SetUpdateFlag();
+  run_queue->Enqueue(task, now + std::chrono::seconds(6));
+  cr->Resume();
+  cr->Release();
+  cr = ctx.NextRoutine();
+  ASSERT_EQ(task->cr, cr);
+  EXPECT_TRUE(now + std::chrono::seconds(6) == task->deadline);
+  cr->Resume();
+  cr->Release();
+  EXPECT_EQ(nullptr, ctx.NextRoutine());
+  EXPECT_EQ(3, task->activations.load());
+}
+
+TEST(SchedulerEdfTest, sched_edf) {
+  GlobalData::Instance()->SetProcessGroup("example_sched_edf");
+  SetState(STATE_INITIALIZED);
+  auto sched = dynamic_cast<SchedulerEdf*>(scheduler::Instance());
+  ASSERT_NE(nullptr, sched);
+
+  std::atomic<int> runs = {0};
+  EXPECT_TRUE(sched->CreateStacklessTask(
+      [&runs]() {
+        runs++;
+        return RoutineState::DATA_WAIT;
+      },
+      "detection"));
+  auto crid = GlobalData::GenerateHashId("detection");
+  EXPECT_TRUE(WaitFor([&runs]() { return runs.load() == 1; }));
+
+  EXPECT_TRUE(sched->NotifyTask(crid));
+  EXPECT_TRUE(WaitFor([&runs]() { return runs.load() == 2; }));
+  EXPECT_TRUE(sched->NotifyTask(crid, Clock::now()));
+  EXPECT_TRUE(WaitFor([&runs]() { return runs.load() == 3; }));
+
+  EXPECT_TRUE(WaitFor([sched]() {
+    return sched->GetDeadlineStats()["detection"].activations == 3;
+  }));
+  auto stats = sched->GetDeadlineStats()["detection"];
+  EXPECT_EQ(1, stats.deadline_misses);
+
+  EXPECT_TRUE(sched->RemoveTask("detection"));
+  EXPECT_FALSE(sched->NotifyTask(crid));
+  sched->Shutdown();
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
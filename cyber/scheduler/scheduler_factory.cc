@@ -29,6 +29,7 @@
 #include "cyber/common/util.h"
 #include "cyber/scheduler/policy/scheduler_choreography.h"
 #include "cyber/scheduler/policy/scheduler_classic.h"
+#include "cyber/scheduler/policy/scheduler_edf.h"
 #include "cyber/scheduler/scheduler.h"
 
 namespace apollo {
@@ -62,6 +63,8 @@ Scheduler* Instance() { // TODO: complete scheduler cfg
       scheduler_instance = new SchedulerClassic();
     } else if (!policy.compare("choreography")) {
       scheduler_instance = new SchedulerChoreography();
+    } else if (!policy.compare("edf")) {
+      scheduler_instance = new SchedulerEdf();
     } else {
       AWARN << "Invalid scheduler policy: " << policy;
       scheduler_instance = new SchedulerClassic();
@@ -17,13 +17,20 @@
 #include "cyber/scheduler/scheduler.h"
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <string>
+#include <thread>
 
 #include "cyber/common/global_data.h"
+#include "cyber/common/util.h"
+#include "cyber/data/data_visitor.h"
 //#include "cyber/cyber.h"
 //#include "cyber/init.h"
 #include "cyber/state.h"
 #include "cyber/proto/scheduler_conf.pb.h"
+#include "cyber/scheduler/policy/classic_context.h"
 #include "cyber/scheduler/processor_context.h"
 #include "cyber/scheduler/scheduler_factory.h"
 
@@ -70,6 +77,109 @@ TEST(SchedulerTest, notify_task) {
   EXPECT_TRUE(sched->NotifyTask(id));
 }
 
+TEST(SchedulerTest, routine_stats) {
+  auto sched = Instance();
+  Init("scheduler_test");
+  std::string name = "stats";
+  auto id = GlobalData::RegisterTaskName(name);
+  std::atomic<int> runs = {0};
+  EXPECT_TRUE(sched->CreateStacklessTask(
+      [&runs]() {
+        ++runs;
+        return croutine::RoutineState::DATA_WAIT;
+      },
+      name));
+  auto activations = [&]() {
+    auto stats = sched->GetRoutineStats();
+    return stats.count(name) ? stats[name].activations : 0;
+  };
+  for (int i = 0; i < 1000 && activations() < 1; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(sched->NotifyTask(id));
+  for (int i = 0; i < 1000 && activations() < 2; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  auto stats = sched->GetRoutineStats()[name];
+  EXPECT_EQ(2, runs.load());
+  EXPECT_EQ(2, stats.activations);
+  EXPECT_EQ(1, stats.wakeups);
+  EXPECT_GT(stats.last_processor, 0);
+  sched->ReportRoutineStats();
+  EXPECT_TRUE(sched->RemoveTask(name));
+}
+
+TEST(SchedulerTest, visitor_notify) {
+  auto sched = Instance();
+  Init("scheduler_test");
+  std::atomic<int> runs = {0};
+  std::string name = "visitor_notify";
+  auto channel_id = common::Hash("/scheduler_test/visitor_notify");
+  auto visitor = std::make_shared<data::DataVisitor<int>>(channel_id, 10);
+  EXPECT_TRUE(sched->CreateStacklessTask(
+      [&runs]() {
+        ++runs;
+        return croutine::RoutineState::DATA_WAIT;
+      },
+      name, visitor));
+  auto wait_runs = [&runs](int n) {
+    for (int i = 0; i < 1000 && runs.load() < n; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return runs.load();
+  };
+  EXPECT_EQ(1, wait_runs(1));
+
+  // the visitor's notifier wakes the routine it was registered with
+  auto msg = std::make_shared<int>(1);
+  EXPECT_TRUE(data::DataDispatcher<int>::Instance()->Dispatch(channel_id, msg));
+  EXPECT_EQ(2, wait_runs(2));
+
+  // a removed routine is not run again
+  EXPECT_TRUE(sched->RemoveTask(name));
+  EXPECT_TRUE(data::DataDispatcher<int>::Instance()->Dispatch(channel_id, msg));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(2, runs.load());
+}
+
+TEST(SchedulerTest, migrate_task) {
+  // example_sched_classic.conf, see create_task
+  auto sched = Instance();
+  Init("scheduler_test");
+  std::atomic<int> runs = {0};
+  std::string name = "classic_migrate";
+  auto id = GlobalData::RegisterTaskName(name);
+  EXPECT_TRUE(sched->CreateStacklessTask(
+      [&runs]() {
+        ++runs;
+        return croutine::RoutineState::DATA_WAIT;
+      },
+      name));
+  auto wait_runs = [&runs](int n) {
+    for (int i = 0; i < 1000 && runs.load() < n; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return runs.load();
+  };
+  EXPECT_EQ(1, wait_runs(1));
+
+  EXPECT_FALSE(sched->MigrateTask(name, "no_such_grp"));
+  EXPECT_FALSE(sched->MigrateTask(name, 0));
+  EXPECT_TRUE(sched->MigrateTask(name, "group2"));
+  EXPECT_TRUE(sched->MigrateTask(name, "group2"));
+  auto& group2 = ClassicContext::cr_group_["group2"][0];
+  EXPECT_EQ(1, std::count_if(group2.begin(), group2.end(),
+                             [id](const std::shared_ptr<CRoutine>& cr) {
+                               return cr->id() == id;
+                             }));
+
+  EXPECT_TRUE(sched->NotifyTask(id));
+  EXPECT_EQ(2, wait_runs(2));
+  // removal finds it in its new group
+  EXPECT_TRUE(sched->RemoveTask(name));
+}
+
 }  // namespace scheduler
 }  // namespace cyber
 }  // namespace apollo
@@ -0,0 +1,85 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/sleep_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+TEST(SleepQueueTest, pop_due) {
+  using Clock = SleepQueue<int>::Clock;
+  using std::chrono::milliseconds;
+  SleepQueue<int> queue;
+  auto now = Clock::now();
+  EXPECT_EQ(Clock::time_point::max(), queue.NextWake());
+
+  queue.Push(now + milliseconds(30), 3);
+  queue.Push(now + milliseconds(10), 1);
+  queue.Push(now + milliseconds(20), 2);
+  queue.Push(now + milliseconds(10), 4);
+  EXPECT_EQ(4, queue.size());
+  EXPECT_EQ(now + milliseconds(10), queue.NextWake());
+
+  // nothing is due before its wake time, ties in the order they came
+  int item = 0;
+  EXPECT_FALSE(queue.PopDue(now + milliseconds(10), &item));
+  EXPECT_TRUE(queue.PopDue(now + milliseconds(25), &item));
+  EXPECT_EQ(1, item);
+  EXPECT_TRUE(queue.PopDue(now + milliseconds(25), &item));
+  EXPECT_EQ(4, item);
+  EXPECT_TRUE(queue.PopDue(now + milliseconds(25), &item));
+  EXPECT_EQ(2, item);
+  EXPECT_FALSE(queue.PopDue(now + milliseconds(25), &item));
+  EXPECT_EQ(now + milliseconds(30), queue.NextWake());
+  EXPECT_TRUE(queue.PopDue(Clock::time_point::max(), &item));
+  EXPECT_EQ(3, item);
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(SleepQueueTest, take_if) {
+  using Clock = SleepQueue<int>::Clock;
+  SleepQueue<int> queue;
+  auto now = Clock::now();
+  for (int i = 0; i < 10; ++i) {
+    queue.Push(now + std::chrono::milliseconds(10 - i), i);
+  }
+
+  std::vector<int> taken;
+  queue.TakeIf([](int i) { return i % 2 == 1; }, &taken);
+  EXPECT_EQ(5, taken.size());
+  for (auto i : taken) {
+    EXPECT_EQ(1, i % 2);
+  }
+
+  // the rest still comes earliest first
+  EXPECT_EQ(5, queue.size());
+  int item = 0;
+  for (int i = 8; i >= 0; i -= 2) {
+    ASSERT_TRUE(queue.PopDue(Clock::time_point::max(), &item));
+    EXPECT_EQ(i, item);
+  }
+  EXPECT_TRUE(queue.Empty());
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,387 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Sweeps INTRA/SHM/RTPS over payload sizes and subscriber counts and prints
+// one JSON object per case. Run with --role=both (default) for a loopback
+// run in one process, or start --role=sub first and then --role=pub with the
+// same flags to measure across processes.
+//
+//   transport_benchmark --modes=shm,rtps --sizes=64,4096,1048576
+//       --subscribers=1,4 --messages=2000 --rate=100 > result.jsonl
+
+#include <sys/resource.h>
+#include <sys/time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gflags/gflags.h"
+
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+#include "cyber/common/util.h"
+#include "cyber/init.h"
+#include "cyber/message/raw_message.h"
+#include "cyber/time/time.h"
+#include "cyber/transport/common/identity.h"
+#include "cyber/transport/transport.h"
+
+DEFINE_string(modes, "intra,shm,rtps", "comma separated transport modes");
+DEFINE_string(sizes,
+              "64,256,1024,4096,16384,65536,262144,1048576,4194304,16777216,"
+              "33554432",
+              "comma separated payload sizes in bytes");
+DEFINE_string(subscribers, "1,2,4,8,16", "comma separated subscriber counts");
+DEFINE_int32(messages, 1000, "messages sent per case");
+DEFINE_int32(rate, 0, "publish rate in Hz, 0 means as fast as possible");
+DEFINE_string(role, "both", "both, pub or sub");
+DEFINE_int32(discovery_ms, 1000,
+             "time given to the underlay to match endpoints before sending");
+DEFINE_int32(drain_ms, 3000,
+             "time to wait for outstanding messages after the last one");
+DEFINE_int32(start_ms, 60000,
+             "time a subscriber waits for the first message of a case, "
+             "covers a publisher started later with --role=pub");
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+using message::RawMessage;
+using proto::OptionalMode;
+
+namespace {
+
+// payload header: send time (monotonic ns) followed by the sequence number
+constexpr size_t kHeaderSize = 2 * sizeof(uint64_t);
+
+struct CaseConf {
+  OptionalMode mode;
+  std::string mode_name;
+  size_t size;
+  int subscribers;
+};
+
+struct CpuUsage {
+  uint64_t user_us = 0;
+  uint64_t sys_us = 0;
+};
+
+CpuUsage GetCpuUsage() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  CpuUsage cpu;
+  cpu.user_us = usage.ru_utime.tv_sec * 1000000ULL + usage.ru_utime.tv_usec;
+  cpu.sys_us = usage.ru_stime.tv_sec * 1000000ULL + usage.ru_stime.tv_usec;
+  return cpu;
+}
+
+uint64_t NowNs() { return Time::MonoTime().ToNanosecond(); }
+
+std::vector<std::string> Split(const std::string& str) {
+  std::vector<std::string> items;
+  std::stringstream ss(str);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+bool ParseMode(const std::string& name, OptionalMode* mode) {
+  if (name == "intra") {
+    *mode = OptionalMode::INTRA;
+  } else if (name == "shm") {
+    *mode = OptionalMode::SHM;
+  } else if (name == "rtps") {
+    *mode = OptionalMode::RTPS;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+RoleAttributes MakeAttr(const CaseConf& conf) {
+  std::string channel = "/transport_benchmark/" + conf.mode_name + "/" +
+                        std::to_string(conf.size) + "/" +
+                        std::to_string(conf.subscribers);
+  RoleAttributes attr;
+  attr.set_host_name(common::GlobalData::Instance()->HostName());
+  attr.set_host_ip(common::GlobalData::Instance()->HostIp());
+  attr.set_process_id(common::GlobalData::Instance()->ProcessId());
+  attr.set_channel_name(channel);
+  attr.set_channel_id(common::Hash(channel));
+  Identity id;
+  attr.set_id(id.HashValue());
+  return attr;
+}
+
+double ToUs(uint64_t ns) { return static_cast<double>(ns) / 1000.0; }
+
+uint64_t Percentile(const std::vector<uint64_t>& sorted, double ratio) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  size_t index = static_cast<size_t>(
+      ratio * static_cast<double>(sorted.size() - 1) + 0.5);
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+class Subscribers {
+ public:
+  explicit Subscribers(const CaseConf& conf)
+      : expected_(static_cast<uint64_t>(FLAGS_messages) * conf.subscribers),
+        latencies_(expected_) {
+    for (int i = 0; i < conf.subscribers; ++i) {
+      auto attr = MakeAttr(conf);
+      // every receiver gets its own id so that none of them is deduplicated
+      Identity id;
+      attr.set_id(id.HashValue());
+      auto receiver = Transport::Instance()->CreateReceiver<RawMessage>(
+          attr,
+          [this](const std::shared_ptr<RawMessage>& msg,
+                 const MessageInfo& msg_info, const RoleAttributes& attr) {
+            (void)msg_info;
+            (void)attr;
+            OnMessage(msg);
+          },
+          conf.mode);
+      if (receiver != nullptr) {
+        receivers_.push_back(receiver);
+      }
+    }
+  }
+
+  ~Subscribers() {
+    for (auto& receiver : receivers_) {
+      receiver->Disable();
+    }
+  }
+
+  // Returns when every expected message arrived, when none came within
+  // |start_ms|, or after |drain_ms| passed without progress once the first
+  // message was seen.
+  void Wait(int start_ms, int drain_ms) {
+    uint64_t last_count = 0;
+    auto last_progress = std::chrono::steady_clock::now();
+    auto timeout = std::chrono::milliseconds(start_ms);
+    while (received_.load() < expected_) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      uint64_t count = received_.load();
+      auto now = std::chrono::steady_clock::now();
+      if (count != last_count) {
+        last_count = count;
+        last_progress = now;
+        timeout = std::chrono::milliseconds(drain_ms);
+      } else if (now - last_progress > timeout) {
+        break;
+      }
+    }
+  }
+
+  uint64_t expected() const { return expected_; }
+  uint64_t received() const {
+    return std::min(received_.load(), expected_);
+  }
+  uint64_t bytes() const { return bytes_.load(); }
+  uint64_t first_ns() const { return first_ns_.load(); }
+  uint64_t last_ns() const { return last_ns_.load(); }
+
+  std::vector<uint64_t> SortedLatencies() const {
+    std::vector<uint64_t> result(latencies_.begin(),
+                                 latencies_.begin() + received());
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+ private:
+  void OnMessage(const std::shared_ptr<RawMessage>& msg) {
+    uint64_t now = NowNs();
+    if (msg->message.size() < kHeaderSize) {
+      return;
+    }
+    uint64_t send_ns = 0;
+    std::memcpy(&send_ns, msg->message.data(), sizeof(send_ns));
+
+    uint64_t index = received_.fetch_add(1);
+    if (index >= expected_) {
+      return;
+    }
+    latencies_[index] = now > send_ns ? now - send_ns : 0;
+    bytes_.fetch_add(msg->message.size());
+
+    uint64_t expected_first = 0;
+    first_ns_.compare_exchange_strong(expected_first, now);
+    last_ns_.store(now);
+  }
+
+  const uint64_t expected_;
+  std::vector<uint64_t> latencies_;
+  std::atomic<uint64_t> received_ = {0};
+  std::atomic<uint64_t> bytes_ = {0};
+  std::atomic<uint64_t> first_ns_ = {0};
+  std::atomic<uint64_t> last_ns_ = {0};
+  std::vector<std::shared_ptr<Receiver<RawMessage>>> receivers_;
+};
+
+uint64_t Publish(const CaseConf& conf) {
+  auto transmitter = Transport::Instance()->CreateTransmitter<RawMessage>(
+      MakeAttr(conf), conf.mode);
+  if (transmitter == nullptr) {
+    AERROR << "create transmitter failed, mode: " << conf.mode_name;
+    return 0;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(FLAGS_discovery_ms));
+
+  auto interval = FLAGS_rate > 0 ? std::chrono::nanoseconds(
+                                       1000000000LL / FLAGS_rate)
+                                 : std::chrono::nanoseconds(0);
+  auto next = std::chrono::steady_clock::now();
+  uint64_t sent = 0;
+  for (uint64_t seq = 0; seq < static_cast<uint64_t>(FLAGS_messages); ++seq) {
+    // a fresh message per send: intra hands out the pointer itself
+    auto msg = std::make_shared<RawMessage>();
+    msg->message.resize(std::max(conf.size, kHeaderSize));
+    uint64_t send_ns = NowNs();
+    std::memcpy(&msg->message[0], &send_ns, sizeof(send_ns));
+    std::memcpy(&msg->message[sizeof(send_ns)], &seq, sizeof(seq));
+    if (transmitter->Transmit(msg)) {
+      ++sent;
+    }
+    if (interval.count() > 0) {
+      next += interval;
+      std::this_thread::sleep_until(next);
+    }
+  }
+  return sent;
+}
+
+void Report(const CaseConf& conf, uint64_t sent, const Subscribers* subs,
+            const CpuUsage& cpu_start, const CpuUsage& cpu_end) {
+  uint64_t cpu_us = (cpu_end.user_us - cpu_start.user_us) +
+                    (cpu_end.sys_us - cpu_start.sys_us);
+  uint64_t handled = subs != nullptr ? subs->received() : sent;
+
+  std::ostringstream out;
+  out << "{\"mode\":\"" << conf.mode_name << "\",\"role\":\"" << FLAGS_role
+      << "\",\"size\":" << conf.size
+      << ",\"subscribers\":" << conf.subscribers
+      << ",\"rate\":" << FLAGS_rate << ",\"sent\":" << sent;
+
+  if (subs != nullptr) {
+    auto latencies = subs->SortedLatencies();
+    double duration_s =
+        subs->last_ns() > subs->first_ns()
+            ? static_cast<double>(subs->last_ns() - subs->first_ns()) / 1e9
+            : 0.0;
+    double msgs_per_s =
+        duration_s > 0 ? static_cast<double>(handled) / duration_s : 0.0;
+    double mb_per_s = duration_s > 0 ? static_cast<double>(subs->bytes()) /
+                                           duration_s / (1024.0 * 1024.0)
+                                     : 0.0;
+    out << ",\"expected\":" << subs->expected()
+        << ",\"received\":" << handled << ",\"throughput_msgs\":" << msgs_per_s
+        << ",\"throughput_mb\":" << mb_per_s
+        << ",\"p50_us\":" << ToUs(Percentile(latencies, 0.5))
+        << ",\"p99_us\":" << ToUs(Percentile(latencies, 0.99))
+        << ",\"p999_us\":" << ToUs(Percentile(latencies, 0.999))
+        << ",\"max_us\":" << ToUs(latencies.empty() ? 0 : latencies.back());
+  }
+
+  out << ",\"cpu_us\":" << cpu_us << ",\"cpu_us_per_msg\":"
+      << (handled > 0 ? static_cast<double>(cpu_us) /
+                            static_cast<double>(handled)
+                      : 0.0)
+      << "}";
+  std::printf("%s\n", out.str().c_str());
+  std::fflush(stdout);
+}
+
+void RunCase(const CaseConf& conf) {
+  std::unique_ptr<Subscribers> subs;
+  uint64_t sent = 0;
+  CpuUsage cpu_start;
+  if (FLAGS_role == "sub") {
+    subs.reset(new Subscribers(conf));
+    cpu_start = GetCpuUsage();
+    subs->Wait(FLAGS_start_ms, FLAGS_drain_ms);
+  } else if (FLAGS_role == "pub") {
+    cpu_start = GetCpuUsage();
+    sent = Publish(conf);
+    // give the subscriber process time to drain before the next case
+    std::this_thread::sleep_for(std::chrono::milliseconds(FLAGS_drain_ms));
+  } else {
+    subs.reset(new Subscribers(conf));
+    cpu_start = GetCpuUsage();
+    sent = Publish(conf);
+    subs->Wait(FLAGS_drain_ms, FLAGS_drain_ms);
+  }
+  Report(conf, sent, subs.get(), cpu_start, GetCpuUsage());
+}
+
+}  // namespace
+
+int Run() {
+  if (FLAGS_role != "both" && FLAGS_role != "pub" && FLAGS_role != "sub") {
+    AERROR << "invalid role: " << FLAGS_role;
+    return -1;
+  }
+
+  for (auto& mode_name : Split(FLAGS_modes)) {
+    CaseConf conf;
+    conf.mode_name = mode_name;
+    if (!ParseMode(mode_name, &conf.mode)) {
+      AERROR << "unsupported mode: " << mode_name;
+      return -1;
+    }
+    if (conf.mode == OptionalMode::INTRA && FLAGS_role != "both") {
+      AWARN << "intra mode only works within one process, skip it.";
+      continue;
+    }
+    for (auto& size : Split(FLAGS_sizes)) {
+      conf.size = std::stoull(size);
+      for (auto& subscribers : Split(FLAGS_subscribers)) {
+        conf.subscribers = std::stoi(subscribers);
+        RunCase(conf);
+      }
+    }
+  }
+  return 0;
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  apollo::cyber::Init(argv[0]);
+  int ret = apollo::cyber::transport::Run();
+  apollo::cyber::transport::Transport::Instance()->Shutdown();
+  apollo::cyber::Clear();
+  return ret;
+}
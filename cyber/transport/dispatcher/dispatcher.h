@@ -51,6 +51,10 @@ template <typename MessageT>
 using MessageListener =
     std::function<void(const std::shared_ptr<MessageT>&, const MessageInfo&)>;
 
+// receives the serialized message, parsing is left to the listener
+using SerializedListener = std::function<void(
+    const std::shared_ptr<std::string>&, const MessageInfo&)>;
+
 class Dispatcher {
  public:
   Dispatcher();
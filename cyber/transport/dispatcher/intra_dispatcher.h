@@ -27,6 +27,7 @@
 #include "cyber/message/message_traits.h"
 #include "cyber/message/raw_message.h"
 #include "cyber/transport/dispatcher/dispatcher.h"
+#include "cyber/transport/message/message_filter.h"
 
 namespace apollo {
 namespace cyber {
@@ -39,6 +40,17 @@ class IntraDispatcher : public Dispatcher {
  public:
   virtual ~IntraDispatcher();
 
+  template <typename MessageT>
+  void AddListener(const RoleAttributes& self_attr,
+                   const MessageListener<MessageT>& listener,
+                   const MessageFilter& filter = nullptr);
+
+  template <typename MessageT>
+  void AddListener(const RoleAttributes& self_attr,
+                   const RoleAttributes& opposite_attr,
+                   const MessageListener<MessageT>& listener,
+                   const MessageFilter& filter = nullptr);
+
   template <typename MessageT>
   void OnMessage(uint64_t channel_id, const std::shared_ptr<MessageT>& message,
                  const MessageInfo& message_info);
@@ -46,6 +58,44 @@ class IntraDispatcher : public Dispatcher {
   DECLARE_SINGLETON(IntraDispatcher)
 };
 
+template <typename MessageT>
+void IntraDispatcher::AddListener(const RoleAttributes& self_attr,
+                                  const MessageListener<MessageT>& listener,
+                                  const MessageFilter& filter) {
+  if (filter == nullptr) {
+    Dispatcher::AddListener<MessageT>(self_attr, listener);
+    return;
+  }
+  auto listener_adapter = [listener, filter](
+                              const std::shared_ptr<MessageT>& msg,
+                              const MessageInfo& msg_info) {
+    if (filter(msg_info, nullptr, 0)) {
+      listener(msg, msg_info);
+    }
+  };
+  Dispatcher::AddListener<MessageT>(self_attr, listener_adapter);
+}
+
+template <typename MessageT>
+void IntraDispatcher::AddListener(const RoleAttributes& self_attr,
+                                  const RoleAttributes& opposite_attr,
+                                  const MessageListener<MessageT>& listener,
+                                  const MessageFilter& filter) {
+  if (filter == nullptr) {
+    Dispatcher::AddListener<MessageT>(self_attr, opposite_attr, listener);
+    return;
+  }
+  auto listener_adapter = [listener, filter](
+                              const std::shared_ptr<MessageT>& msg,
+                              const MessageInfo& msg_info) {
+    if (filter(msg_info, nullptr, 0)) {
+      listener(msg, msg_info);
+    }
+  };
+  Dispatcher::AddListener<MessageT>(self_attr, opposite_attr,
+                                    listener_adapter);
+}
+
 template <typename MessageT>
 void IntraDispatcher::OnMessage(uint64_t channel_id,
                                 const std::shared_ptr<MessageT>& message,
@@ -78,6 +78,39 @@ TEST(IntraDispatcherTest, on_message) {
   EXPECT_EQ(recv_raw_msg->message, send_raw_msg->message);
 }
 
+TEST(IntraDispatcherTest, filter) {
+  auto dispatcher = IntraDispatcher::Instance();
+
+  RoleAttributes attr;
+  attr.set_channel_name("filter_channel");
+  attr.set_channel_id(common::Hash("filter_channel"));
+  Identity self_id;
+  attr.set_id(self_id.HashValue());
+
+  int recv_count = 0;
+  dispatcher->AddListener<proto::Chatter>(
+      attr,
+      [&recv_count](const std::shared_ptr<proto::Chatter>& msg,
+                    const MessageInfo& msg_info) {
+        (void)msg;
+        EXPECT_EQ(msg_info.seq_num() % 2, 0);
+        ++recv_count;
+      },
+      [](const MessageInfo& msg_info, const char* buf, std::size_t size) {
+        EXPECT_EQ(buf, nullptr);
+        EXPECT_EQ(size, 0);
+        return msg_info.seq_num() % 2 == 0;
+      });
+
+  auto msg = std::make_shared<proto::Chatter>();
+  MessageInfo msg_info;
+  for (uint64_t seq = 0; seq < 10; ++seq) {
+    msg_info.set_seq_num(seq);
+    dispatcher->OnMessage(common::Hash("filter_channel"), msg, msg_info);
+  }
+  EXPECT_EQ(recv_count, 5);
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
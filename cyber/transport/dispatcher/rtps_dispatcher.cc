@@ -39,6 +39,42 @@ void RtpsDispatcher::Shutdown() {
   participant_ = nullptr;
 }
 
+void RtpsDispatcher::AddSerializedListener(const RoleAttributes& self_attr,
+                                           const SerializedListener& listener,
+                                           const MessageFilter& filter) {
+  auto listener_adapter = [listener, filter](
+                              const std::shared_ptr<std::string>& msg_str,
+                              const MessageInfo& msg_info) {
+    if (filter != nullptr &&
+        !filter(msg_info, msg_str->data(), msg_str->size())) {
+      return;
+    }
+    listener(msg_str, msg_info);
+  };
+
+  Dispatcher::AddListener<std::string>(self_attr, listener_adapter);
+  AddSubscriber(self_attr);
+}
+
+void RtpsDispatcher::AddSerializedListener(const RoleAttributes& self_attr,
+                                           const RoleAttributes& opposite_attr,
+                                           const SerializedListener& listener,
+                                           const MessageFilter& filter) {
+  auto listener_adapter = [listener, filter](
+                              const std::shared_ptr<std::string>& msg_str,
+                              const MessageInfo& msg_info) {
+    if (filter != nullptr &&
+        !filter(msg_info, msg_str->data(), msg_str->size())) {
+      return;
+    }
+    listener(msg_str, msg_info);
+  };
+
+  Dispatcher::AddListener<std::string>(self_attr, opposite_attr,
+                                       listener_adapter);
+  AddSubscriber(self_attr);
+}
+
 void RtpsDispatcher::AddSubscriber(const RoleAttributes& self_attr) {
   if (participant_ == nullptr) {
     AWARN << "please set participant firstly.";
@@ -27,6 +27,7 @@
 #include "cyber/common/macros.h"
 #include "cyber/message/message_traits.h"
 #include "cyber/transport/dispatcher/dispatcher.h"
+#include "cyber/transport/message/message_filter.h"
 #include "cyber/transport/rtps/attributes_filler.h"
 #include "cyber/transport/rtps/participant.h"
 #include "cyber/transport/rtps/sub_listener.h"
@@ -53,12 +54,24 @@ class RtpsDispatcher : public Dispatcher {
 
   template <typename MessageT>
   void AddListener(const RoleAttributes& self_attr,
-                   const MessageListener<MessageT>& listener);
+                   const MessageListener<MessageT>& listener,
+                   const MessageFilter& filter = nullptr);
 
   template <typename MessageT>
   void AddListener(const RoleAttributes& self_attr,
                    const RoleAttributes& opposite_attr,
-                   const MessageListener<MessageT>& listener);
+                   const MessageListener<MessageT>& listener,
+                   const MessageFilter& filter = nullptr);
+
+  // skips parsing, for readers that deserialize only what they consume
+  void AddSerializedListener(const RoleAttributes& self_attr,
+                             const SerializedListener& listener,
+                             const MessageFilter& filter = nullptr);
+
+  void AddSerializedListener(const RoleAttributes& self_attr,
+                             const RoleAttributes& opposite_attr,
+                             const SerializedListener& listener,
+                             const MessageFilter& filter = nullptr);
 
   void set_participant(const ParticipantPtr& participant) {
     participant_ = participant;
@@ -80,10 +93,15 @@ class RtpsDispatcher : public Dispatcher {
 
 template <typename MessageT>
 void RtpsDispatcher::AddListener(const RoleAttributes& self_attr,
-                                 const MessageListener<MessageT>& listener) {
-  auto listener_adapter = [listener](
+                                 const MessageListener<MessageT>& listener,
+                                 const MessageFilter& filter) {
+  auto listener_adapter = [listener, filter](
                               const std::shared_ptr<std::string>& msg_str,
                               const MessageInfo& msg_info) {
+    if (filter != nullptr &&
+        !filter(msg_info, msg_str->data(), msg_str->size())) {
+      return;
+    }
     auto msg = std::make_shared<MessageT>();
     RETURN_IF(!message::ParseFromString(*msg_str, msg.get()));
     listener(msg, msg_info);
@@ -96,10 +114,15 @@ void RtpsDispatcher::AddListener(const RoleAttributes& self_attr,
 template <typename MessageT>
 void RtpsDispatcher::AddListener(const RoleAttributes& self_attr,
                                  const RoleAttributes& opposite_attr,
-                                 const MessageListener<MessageT>& listener) {
-  auto listener_adapter = [listener](
+                                 const MessageListener<MessageT>& listener,
+                                 const MessageFilter& filter) {
+  auto listener_adapter = [listener, filter](
                               const std::shared_ptr<std::string>& msg_str,
                               const MessageInfo& msg_info) {
+    if (filter != nullptr &&
+        !filter(msg_info, msg_str->data(), msg_str->size())) {
+      return;
+    }
     auto msg = std::make_shared<MessageT>();
     RETURN_IF(!message::ParseFromString(*msg_str, msg.get()));
     listener(msg, msg_info);
@@ -45,6 +45,45 @@ void ShmDispatcher::Shutdown() {
   }
 }
 
+void ShmDispatcher::AddSerializedListener(const RoleAttributes& self_attr,
+                                          const SerializedListener& listener,
+                                          const MessageFilter& filter) {
+  auto listener_adapter = [listener, filter](
+                              const std::shared_ptr<ReadableBlock>& rb,
+                              const MessageInfo& msg_info) {
+    auto buf = reinterpret_cast<const char*>(rb->buf);
+    auto size = rb->block->msg_size();
+    if (filter != nullptr && !filter(msg_info, buf, size)) {
+      return;
+    }
+    // the block goes back to the segment right after this call
+    listener(std::make_shared<std::string>(buf, size), msg_info);
+  };
+
+  Dispatcher::AddListener<ReadableBlock>(self_attr, listener_adapter);
+  AddSegment(self_attr);
+}
+
+void ShmDispatcher::AddSerializedListener(const RoleAttributes& self_attr,
+                                          const RoleAttributes& opposite_attr,
+                                          const SerializedListener& listener,
+                                          const MessageFilter& filter) {
+  auto listener_adapter = [listener, filter](
+                              const std::shared_ptr<ReadableBlock>& rb,
+                              const MessageInfo& msg_info) {
+    auto buf = reinterpret_cast<const char*>(rb->buf);
+    auto size = rb->block->msg_size();
+    if (filter != nullptr && !filter(msg_info, buf, size)) {
+      return;
+    }
+    listener(std::make_shared<std::string>(buf, size), msg_info);
+  };
+
+  Dispatcher::AddListener<ReadableBlock>(self_attr, opposite_attr,
+                                         listener_adapter);
+  AddSegment(self_attr);
+}
+
 void ShmDispatcher::AddSegment(const RoleAttributes& self_attr) {
   uint64_t channel_id = self_attr.channel_id();
   WriteLockGuard<AtomicRWLock> lock(segments_lock_);
@@ -29,6 +29,7 @@
 #include "cyber/common/macros.h"
 #include "cyber/message/message_traits.h"
 #include "cyber/transport/dispatcher/dispatcher.h"
+#include "cyber/transport/message/message_filter.h"
 #include "cyber/transport/shm/notifier_factory.h"
 #include "cyber/transport/shm/segment.h"
 
@@ -53,12 +54,24 @@ class ShmDispatcher : public Dispatcher {
 
   template <typename MessageT>
   void AddListener(const RoleAttributes& self_attr,
-                   const MessageListener<MessageT>& listener);
+                   const MessageListener<MessageT>& listener,
+                   const MessageFilter& filter = nullptr);
 
   template <typename MessageT>
   void AddListener(const RoleAttributes& self_attr,
                    const RoleAttributes& opposite_attr,
-                   const MessageListener<MessageT>& listener);
+                   const MessageListener<MessageT>& listener,
+                   const MessageFilter& filter = nullptr);
+
+  // skips parsing, for readers that deserialize only what they consume
+  void AddSerializedListener(const RoleAttributes& self_attr,
+                             const SerializedListener& listener,
+                             const MessageFilter& filter = nullptr);
+
+  void AddSerializedListener(const RoleAttributes& self_attr,
+                             const RoleAttributes& opposite_attr,
+                             const SerializedListener& listener,
+                             const MessageFilter& filter = nullptr);
 
  private:
   void AddSegment(const RoleAttributes& self_attr);
@@ -80,10 +93,17 @@ class ShmDispatcher : public Dispatcher {
 
 template <typename MessageT>
 void ShmDispatcher::AddListener(const RoleAttributes& self_attr,
-                                const MessageListener<MessageT>& listener) {
+                                const MessageListener<MessageT>& listener,
+                                const MessageFilter& filter) {
   // FIXME: make it more clean
-  auto listener_adapter = [listener](const std::shared_ptr<ReadableBlock>& rb,
-                                     const MessageInfo& msg_info) {
+  auto listener_adapter = [listener, filter](
+                              const std::shared_ptr<ReadableBlock>& rb,
+                              const MessageInfo& msg_info) {
+    if (filter != nullptr &&
+        !filter(msg_info, reinterpret_cast<const char*>(rb->buf),
+                rb->block->msg_size())) {
+      return;
+    }
     auto msg = std::make_shared<MessageT>();
     RETURN_IF(!message::ParseFromArray(
         rb->buf, static_cast<int>(rb->block->msg_size()), msg.get()));
@@ -97,10 +117,17 @@ void ShmDispatcher::AddListener(const RoleAttributes& self_attr,
 template <typename MessageT>
 void ShmDispatcher::AddListener(const RoleAttributes& self_attr,
                                 const RoleAttributes& opposite_attr,
-                                const MessageListener<MessageT>& listener) {
+                                const MessageListener<MessageT>& listener,
+                                const MessageFilter& filter) {
   // FIXME: make it more clean
-  auto listener_adapter = [listener](const std::shared_ptr<ReadableBlock>& rb,
-                                     const MessageInfo& msg_info) {
+  auto listener_adapter = [listener, filter](
+                              const std::shared_ptr<ReadableBlock>& rb,
+                              const MessageInfo& msg_info) {
+    if (filter != nullptr &&
+        !filter(msg_info, reinterpret_cast<const char*>(rb->buf),
+                rb->block->msg_size())) {
+      return;
+    }
     auto msg = std::make_shared<MessageT>();
     RETURN_IF(!message::ParseFromArray(
         rb->buf, static_cast<int>(rb->block->msg_size()), msg.get()));
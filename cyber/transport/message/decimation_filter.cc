@@ -0,0 +1,67 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/message/decimation_filter.h"
+
+#include <atomic>
+#include <memory>
+
+#include "cyber/time/time.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+namespace {
+
+struct DecimationState {
+  std::atomic<uint64_t> count = {0};
+  std::atomic<uint64_t> last_kept_ns = {0};
+};
+
+}  // namespace
+
+MessageFilter MakeDecimationFilter(uint32_t keep_every,
+                                   uint64_t min_interval_ns,
+                                   const MessageFilter& next) {
+  auto state = std::make_shared<DecimationState>();
+  return [keep_every, min_interval_ns, next, state](
+             const MessageInfo& msg_info, const char* buf, std::size_t size) {
+    if (next != nullptr && !next(msg_info, buf, size)) {
+      return false;
+    }
+    if (keep_every > 1 &&
+        state->count.fetch_add(1, std::memory_order_relaxed) % keep_every !=
+            0) {
+      return false;
+    }
+    if (min_interval_ns == 0) {
+      return true;
+    }
+    uint64_t now = Time::MonoTime().ToNanosecond();
+    uint64_t last = state->last_kept_ns.load(std::memory_order_relaxed);
+    // the first message is always kept
+    if (last != 0 && now - last < min_interval_ns) {
+      return false;
+    }
+    return state->last_kept_ns.compare_exchange_strong(
+        last, now, std::memory_order_relaxed);
+  };
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,39 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_MESSAGE_DECIMATION_FILTER_H_
+#define CYBER_TRANSPORT_MESSAGE_DECIMATION_FILTER_H_
+
+#include <cstdint>
+
+#include "cyber/transport/message/message_filter.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+// Keeps every |keep_every|-th message (all of them for 0 or 1) and drops
+// those arriving less than |min_interval_ns| after the last kept one. Only
+// messages passing |next|, when given, are counted.
+MessageFilter MakeDecimationFilter(uint32_t keep_every,
+                                   uint64_t min_interval_ns,
+                                   const MessageFilter& next = nullptr);
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_MESSAGE_DECIMATION_FILTER_H_
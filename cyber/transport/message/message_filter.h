@@ -0,0 +1,41 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_MESSAGE_MESSAGE_FILTER_H_
+#define CYBER_TRANSPORT_MESSAGE_MESSAGE_FILTER_H_
+
+#include <cstddef>
+#include <functional>
+
+#include "cyber/transport/message/message_info.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+// Evaluated by the dispatchers before a message is parsed and handed to a
+// listener; returning false drops the message for that listener only.
+// |buf| and |size| expose the serialized payload so that a filter can peek
+// at a header field. They are nullptr and 0 on the intra-process path,
+// where the message is never serialized.
+using MessageFilter = std::function<bool(const MessageInfo& msg_info,
+                                         const char* buf, std::size_t size)>;
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_MESSAGE_MESSAGE_FILTER_H_
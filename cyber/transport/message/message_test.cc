@@ -22,6 +22,7 @@
 #include "cyber/common/global_data.h"
 #include "cyber/message/raw_message.h"
 #include "cyber/transport/message/history.h"
+#include "cyber/transport/message/decimation_filter.h"
 #include "cyber/transport/message/history_attributes.h"
 #include "cyber/transport/message/listener_handler.h"
 #include "cyber/transport/message/message_info.h"
@@ -163,6 +164,32 @@ TEST(ListenerHandlerTest, listener_handler_test) {
   EXPECT_EQ(2, call_count);
 }
 
+TEST(DecimationFilterTest, decimation_filter_test) {
+  MessageInfo info;
+  auto every_third = MakeDecimationFilter(3, 0);
+  int kept = 0;
+  for (int i = 0; i < 9; ++i) {
+    kept += every_third(info, nullptr, 0) ? 1 : 0;
+  }
+  EXPECT_EQ(3, kept);
+
+  // only messages passing the next filter are counted
+  bool pass = false;
+  auto chained = MakeDecimationFilter(
+      2, 0, [&pass](const MessageInfo&, const char*, std::size_t) {
+        return pass;
+      });
+  EXPECT_FALSE(chained(info, nullptr, 0));
+  pass = true;
+  EXPECT_TRUE(chained(info, nullptr, 0));
+  EXPECT_FALSE(chained(info, nullptr, 0));
+  EXPECT_TRUE(chained(info, nullptr, 0));
+
+  auto interval = MakeDecimationFilter(0, 1000000000);
+  EXPECT_TRUE(interval(info, nullptr, 0));
+  EXPECT_FALSE(interval(info, nullptr, 0));
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
@@ -71,6 +71,10 @@ class HybridReceiver : public Receiver<M> {
   void Enable(const RoleAttributes& opposite_attr) override;
   void Disable(const RoleAttributes& opposite_attr) override;
 
+  void SetFilter(const MessageFilter& filter) override;
+  void SetSerializedListener(
+      const typename Receiver<M>::SerializedListener& listener) override;
+
  private:
   void InitMode();
   void ObtainConfig();
@@ -159,6 +163,25 @@ void HybridReceiver<M>::Disable(const RoleAttributes& opposite_attr) {
   }
 }
 
+template <typename M>
+void HybridReceiver<M>::SetFilter(const MessageFilter& filter) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  this->filter_ = filter;
+  for (auto& item : receivers_) {
+    item.second->SetFilter(filter);
+  }
+}
+
+template <typename M>
+void HybridReceiver<M>::SetSerializedListener(
+    const typename Receiver<M>::SerializedListener& listener) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  this->serialized_listener_ = listener;
+  for (auto& item : receivers_) {
+    item.second->SetSerializedListener(listener);
+  }
+}
+
 template <typename M>
 void HybridReceiver<M>::InitMode() {
   mode_ = std::make_shared<proto::CommunicationMode>();
@@ -62,8 +62,10 @@ void IntraReceiver<M>::Enable() {
   }
 
   dispatcher_->AddListener<M>(
-      this->attr_, std::bind(&IntraReceiver<M>::OnNewMessage, this,
-                             std::placeholders::_1, std::placeholders::_2));
+      this->attr_,
+      std::bind(&IntraReceiver<M>::OnNewMessage, this, std::placeholders::_1,
+                std::placeholders::_2),
+      this->filter_);
   this->enabled_ = true;
 }
 
@@ -82,7 +84,8 @@ void IntraReceiver<M>::Enable(const RoleAttributes& opposite_attr) {
   dispatcher_->AddListener<M>(
       this->attr_, opposite_attr,
       std::bind(&IntraReceiver<M>::OnNewMessage, this, std::placeholders::_1,
-                std::placeholders::_2));
+                std::placeholders::_2),
+      this->filter_);
 }
 
 template <typename M>
@@ -19,9 +19,11 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 
 #include "cyber/transport/common/endpoint.h"
 #include "cyber/transport/message/history.h"
+#include "cyber/transport/message/message_filter.h"
 #include "cyber/transport/message/message_info.h"
 
 namespace apollo {
@@ -34,6 +36,9 @@ class Receiver : public Endpoint {
   using MessagePtr = std::shared_ptr<M>;
   using MessageListener = std::function<void(
       const MessagePtr&, const MessageInfo&, const RoleAttributes&)>;
+  using SerializedListener =
+      std::function<void(const std::shared_ptr<std::string>&,
+                         const MessageInfo&, const RoleAttributes&)>;
 
   Receiver(const RoleAttributes& attr, const MessageListener& msg_listener);
   virtual ~Receiver();
@@ -43,16 +48,30 @@ class Receiver : public Endpoint {
   virtual void Enable(const RoleAttributes& opposite_attr) = 0;
   virtual void Disable(const RoleAttributes& opposite_attr) = 0;
 
+  // takes effect on the next Enable()
+  virtual void SetFilter(const MessageFilter& filter) { filter_ = filter; }
+
+  // Shm and rtps messages then go to |listener| unparsed instead of to the
+  // message listener, intra messages are never serialized and still take
+  // the message listener. Takes effect on the next Enable().
+  virtual void SetSerializedListener(const SerializedListener& listener) {
+    serialized_listener_ = listener;
+  }
+
  protected:
   void OnNewMessage(const MessagePtr& msg, const MessageInfo& msg_info);
+  void OnNewSerialized(const std::shared_ptr<std::string>& msg_str,
+                       const MessageInfo& msg_info);
 
   MessageListener msg_listener_;
+  MessageFilter filter_;
+  SerializedListener serialized_listener_;
 };
 
 template <typename M>
 Receiver<M>::Receiver(const RoleAttributes& attr,
                       const MessageListener& msg_listener)
-    : Endpoint(attr), msg_listener_(msg_listener) {}
+    : Endpoint(attr), msg_listener_(msg_listener), filter_(nullptr) {}
 
 template <typename M>
 Receiver<M>::~Receiver() {}
@@ -65,6 +84,14 @@ void Receiver<M>::OnNewMessage(const MessagePtr& msg,
   }
 }
 
+template <typename M>
+void Receiver<M>::OnNewSerialized(const std::shared_ptr<std::string>& msg_str,
+                                  const MessageInfo& msg_info) {
+  if (serialized_listener_ != nullptr) {
+    serialized_listener_(msg_str, msg_info, attr_);
+  }
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
@@ -60,9 +60,19 @@ void RtpsReceiver<M>::Enable() {
   if (this->enabled_) {
     return;
   }
-  dispatcher_->AddListener<M>(
-      this->attr_, std::bind(&RtpsReceiver<M>::OnNewMessage, this,
-                             std::placeholders::_1, std::placeholders::_2));
+  if (this->serialized_listener_ != nullptr) {
+    dispatcher_->AddSerializedListener(
+        this->attr_,
+        std::bind(&RtpsReceiver<M>::OnNewSerialized, this,
+                  std::placeholders::_1, std::placeholders::_2),
+        this->filter_);
+  } else {
+    dispatcher_->AddListener<M>(
+        this->attr_,
+        std::bind(&RtpsReceiver<M>::OnNewMessage, this, std::placeholders::_1,
+                  std::placeholders::_2),
+        this->filter_);
+  }
   this->enabled_ = true;
 }
 
@@ -77,10 +87,19 @@ void RtpsReceiver<M>::Disable() {
 
 template <typename M>
 void RtpsReceiver<M>::Enable(const RoleAttributes& opposite_attr) {
-  dispatcher_->AddListener<M>(
-      this->attr_, opposite_attr,
-      std::bind(&RtpsReceiver<M>::OnNewMessage, this, std::placeholders::_1,
-                std::placeholders::_2));
+  if (this->serialized_listener_ != nullptr) {
+    dispatcher_->AddSerializedListener(
+        this->attr_, opposite_attr,
+        std::bind(&RtpsReceiver<M>::OnNewSerialized, this,
+                  std::placeholders::_1, std::placeholders::_2),
+        this->filter_);
+  } else {
+    dispatcher_->AddListener<M>(
+        this->attr_, opposite_attr,
+        std::bind(&RtpsReceiver<M>::OnNewMessage, this, std::placeholders::_1,
+                  std::placeholders::_2),
+        this->filter_);
+  }
 }
 
 template <typename M>
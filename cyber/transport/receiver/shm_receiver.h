@@ -63,9 +63,19 @@ void ShmReceiver<M>::Enable() {
     return;
   }
 
-  dispatcher_->AddListener<M>(
-      this->attr_, std::bind(&ShmReceiver<M>::OnNewMessage, this,
-                             std::placeholders::_1, std::placeholders::_2));
+  if (this->serialized_listener_ != nullptr) {
+    dispatcher_->AddSerializedListener(
+        this->attr_,
+        std::bind(&ShmReceiver<M>::OnNewSerialized, this,
+                  std::placeholders::_1, std::placeholders::_2),
+        this->filter_);
+  } else {
+    dispatcher_->AddListener<M>(
+        this->attr_,
+        std::bind(&ShmReceiver<M>::OnNewMessage, this, std::placeholders::_1,
+                  std::placeholders::_2),
+        this->filter_);
+  }
   this->enabled_ = true;
 }
 
@@ -81,10 +91,19 @@ void ShmReceiver<M>::Disable() {
 
 template <typename M>
 void ShmReceiver<M>::Enable(const RoleAttributes& opposite_attr) {
-  dispatcher_->AddListener<M>(
-      this->attr_, opposite_attr,
-      std::bind(&ShmReceiver<M>::OnNewMessage, this, std::placeholders::_1,
-                std::placeholders::_2));
+  if (this->serialized_listener_ != nullptr) {
+    dispatcher_->AddSerializedListener(
+        this->attr_, opposite_attr,
+        std::bind(&ShmReceiver<M>::OnNewSerialized, this,
+                  std::placeholders::_1, std::placeholders::_2),
+        this->filter_);
+  } else {
+    dispatcher_->AddListener<M>(
+        this->attr_, opposite_attr,
+        std::bind(&ShmReceiver<M>::OnNewMessage, this, std::placeholders::_1,
+                  std::placeholders::_2),
+        this->filter_);
+  }
 }
 
 template <typename M>
@@ -0,0 +1,226 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/rtps/payload_compressor.h"
+
+#include <sstream>
+#include <vector>
+
+#include "cyber/common/global_data.h"
+#include "cyber/common/log.h"
+#include "lz4.h"
+#include "zstd.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+namespace {
+
+constexpr size_t kRawSizeLen = sizeof(uint32_t);
+
+// Upper bounds of raw size over frame size. An LZ4 sequence byte expands
+// into at most 255 bytes, a zstd block of at most 128 KiB takes at least 4
+// bytes when it is a single repeated byte.
+constexpr uint64_t kLz4MaxRatio = 255;
+constexpr uint64_t kZstdMaxRatio = 128 * 1024 / 4;
+
+void PutRawSize(uint32_t size, char* dst) {
+  for (size_t i = 0; i < kRawSizeLen; ++i) {
+    dst[i] = static_cast<char>((size >> (8 * i)) & 0xFF);
+  }
+}
+
+uint32_t GetRawSize(const char* src) {
+  uint32_t size = 0;
+  for (size_t i = 0; i < kRawSizeLen; ++i) {
+    size |= static_cast<uint32_t>(static_cast<uint8_t>(src[i])) << (8 * i);
+  }
+  return size;
+}
+
+struct ZstdContext {
+  ZstdContext() : cctx(ZSTD_createCCtx()), dctx(ZSTD_createDCtx()) {}
+  ~ZstdContext() {
+    ZSTD_freeCCtx(cctx);
+    ZSTD_freeDCtx(dctx);
+  }
+  ZSTD_CCtx* cctx;
+  ZSTD_DCtx* dctx;
+};
+
+// zstd contexts are reused per thread to keep allocation off the send and
+// receive paths.
+ZstdContext* GetZstdContext() {
+  static thread_local ZstdContext context;
+  return &context;
+}
+
+}  // namespace
+
+bool PayloadCompressor::Compress(QosCompressionPolicy policy, int level,
+                                 const std::string& src, std::string* dst) {
+  RETURN_VAL_IF_NULL(dst, false);
+  if (src.size() > UINT32_MAX) {
+    return false;
+  }
+
+  switch (policy) {
+    case QosCompressionPolicy::COMPRESSION_LZ4: {
+      if (src.size() > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+        return false;
+      }
+      int bound = LZ4_compressBound(static_cast<int>(src.size()));
+      dst->resize(kRawSizeLen + bound);
+      int len = LZ4_compress_default(src.data(), &(*dst)[kRawSizeLen],
+                                     static_cast<int>(src.size()), bound);
+      if (len <= 0) {
+        return false;
+      }
+      dst->resize(kRawSizeLen + len);
+      break;
+    }
+    case QosCompressionPolicy::COMPRESSION_ZSTD: {
+      size_t bound = ZSTD_compressBound(src.size());
+      dst->resize(kRawSizeLen + bound);
+      size_t len =
+          ZSTD_compressCCtx(GetZstdContext()->cctx, &(*dst)[kRawSizeLen],
+                            bound, src.data(), src.size(), level);
+      if (ZSTD_isError(len)) {
+        AERROR << "zstd compress failed: " << ZSTD_getErrorName(len);
+        return false;
+      }
+      dst->resize(kRawSizeLen + len);
+      break;
+    }
+    default:
+      return false;
+  }
+
+  PutRawSize(static_cast<uint32_t>(src.size()), &(*dst)[0]);
+  return true;
+}
+
+bool PayloadCompressor::Decompress(QosCompressionPolicy policy,
+                                   const std::string& src, std::string* dst) {
+  RETURN_VAL_IF_NULL(dst, false);
+  if (src.size() < kRawSizeLen) {
+    return false;
+  }
+
+  // the raw size comes off the wire, it is checked against the frame
+  // before anything is allocated for it
+  uint32_t raw_size = GetRawSize(src.data());
+  const char* frame = src.data() + kRawSizeLen;
+  size_t frame_size = src.size() - kRawSizeLen;
+
+  switch (policy) {
+    case QosCompressionPolicy::COMPRESSION_LZ4: {
+      if (raw_size > static_cast<uint32_t>(LZ4_MAX_INPUT_SIZE) ||
+          raw_size > frame_size * kLz4MaxRatio) {
+        AWARN << "lz4 frame of " << frame_size << " bytes claims " << raw_size
+              << " raw bytes, dropped.";
+        return false;
+      }
+      dst->resize(raw_size);
+      int len = LZ4_decompress_safe(frame, &(*dst)[0],
+                                    static_cast<int>(frame_size),
+                                    static_cast<int>(raw_size));
+      if (len < 0 || static_cast<uint32_t>(len) != raw_size) {
+        return false;
+      }
+      break;
+    }
+    case QosCompressionPolicy::COMPRESSION_ZSTD: {
+      // Compress always records the content size in the frame header
+      if (ZSTD_getFrameContentSize(frame, frame_size) != raw_size ||
+          raw_size > frame_size * kZstdMaxRatio) {
+        AWARN << "zstd frame of " << frame_size << " bytes does not hold "
+              << raw_size << " raw bytes, dropped.";
+        return false;
+      }
+      dst->resize(raw_size);
+      size_t len = ZSTD_decompressDCtx(GetZstdContext()->dctx, &(*dst)[0],
+                                       raw_size, frame, frame_size);
+      if (ZSTD_isError(len) || len != raw_size) {
+        return false;
+      }
+      break;
+    }
+    default:
+      return false;
+  }
+  return true;
+}
+
+CompressionStatistics::CompressionStatistics() {}
+
+ChannelCompressionStatPtr CompressionStatistics::GetChannelStat(
+    uint64_t channel_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& stat = stats_[channel_id];
+  if (stat == nullptr) {
+    stat = std::make_shared<ChannelCompressionStat>();
+  }
+  return stat;
+}
+
+bool CompressionStatistics::GetStat(uint64_t channel_id,
+                                    CompressionStat* stat) {
+  RETURN_VAL_IF_NULL(stat, false);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = stats_.find(channel_id);
+  if (iter == stats_.end()) {
+    return false;
+  }
+  auto& s = iter->second;
+  stat->compressed_samples = s->compressed_samples.load();
+  stat->raw_bytes = s->raw_bytes.load();
+  stat->compressed_bytes = s->compressed_bytes.load();
+  stat->compress_ns = s->compress_ns.load();
+  stat->decompressed_samples = s->decompressed_samples.load();
+  stat->decompress_ns = s->decompress_ns.load();
+  return true;
+}
+
+std::string CompressionStatistics::DebugString() {
+  std::vector<uint64_t> channels;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& item : stats_) {
+      channels.emplace_back(item.first);
+    }
+  }
+
+  std::stringstream ss;
+  for (auto channel_id : channels) {
+    CompressionStat stat;
+    if (!GetStat(channel_id, &stat)) {
+      continue;
+    }
+    ss << common::GlobalData::GetChannelById(channel_id)
+       << " compressed_samples: " << stat.compressed_samples
+       << " ratio: " << stat.Ratio() << " compress_us: "
+       << stat.compress_ns / 1000
+       << " decompressed_samples: " << stat.decompressed_samples
+       << " decompress_us: " << stat.decompress_ns / 1000 << "\n";
+  }
+  return ss.str();
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,124 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_RTPS_PAYLOAD_COMPRESSOR_H_
+#define CYBER_TRANSPORT_RTPS_PAYLOAD_COMPRESSOR_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "cyber/common/macros.h"
+#include "cyber/proto/qos_profile.pb.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+using cyber::proto::QosCompressionPolicy;
+
+// The codec of a compressed sample is carried in the top byte of the high
+// word of the related sample identity's sequence number.
+constexpr uint32_t COMPRESSION_FLAG_SHIFT = 24;
+constexpr uint32_t SEQ_NUM_HIGH_MASK = 0x00FFFFFF;
+
+inline int32_t SetCompressionFlag(int32_t seq_high,
+                                  QosCompressionPolicy policy) {
+  return static_cast<int32_t>(
+      (static_cast<uint32_t>(seq_high) & SEQ_NUM_HIGH_MASK) |
+      (static_cast<uint32_t>(policy) << COMPRESSION_FLAG_SHIFT));
+}
+
+inline QosCompressionPolicy GetCompressionFlag(int32_t seq_high) {
+  return static_cast<QosCompressionPolicy>(static_cast<uint32_t>(seq_high) >>
+                                           COMPRESSION_FLAG_SHIFT);
+}
+
+inline int32_t ClearCompressionFlag(int32_t seq_high) {
+  return static_cast<int32_t>(static_cast<uint32_t>(seq_high) &
+                              SEQ_NUM_HIGH_MASK);
+}
+
+class PayloadCompressor {
+ public:
+  // Compressed payload layout: 4 bytes little-endian raw size + codec frame.
+  static bool Compress(QosCompressionPolicy policy, int level,
+                       const std::string& src, std::string* dst);
+  static bool Decompress(QosCompressionPolicy policy, const std::string& src,
+                         std::string* dst);
+};
+
+struct CompressionStat {
+  uint64_t compressed_samples = 0;
+  uint64_t raw_bytes = 0;
+  uint64_t compressed_bytes = 0;
+  uint64_t compress_ns = 0;
+  uint64_t decompressed_samples = 0;
+  uint64_t decompress_ns = 0;
+
+  double Ratio() const {
+    return compressed_bytes == 0
+               ? 0.0
+               : static_cast<double>(raw_bytes) /
+                     static_cast<double>(compressed_bytes);
+  }
+};
+
+struct ChannelCompressionStat {
+  std::atomic<uint64_t> compressed_samples = {0};
+  std::atomic<uint64_t> raw_bytes = {0};
+  std::atomic<uint64_t> compressed_bytes = {0};
+  std::atomic<uint64_t> compress_ns = {0};
+  std::atomic<uint64_t> decompressed_samples = {0};
+  std::atomic<uint64_t> decompress_ns = {0};
+
+  void AddCompress(uint64_t raw, uint64_t compressed, uint64_t ns) {
+    compressed_samples.fetch_add(1, std::memory_order_relaxed);
+    raw_bytes.fetch_add(raw, std::memory_order_relaxed);
+    compressed_bytes.fetch_add(compressed, std::memory_order_relaxed);
+    compress_ns.fetch_add(ns, std::memory_order_relaxed);
+  }
+
+  void AddDecompress(uint64_t ns) {
+    decompressed_samples.fetch_add(1, std::memory_order_relaxed);
+    decompress_ns.fetch_add(ns, std::memory_order_relaxed);
+  }
+};
+using ChannelCompressionStatPtr = std::shared_ptr<ChannelCompressionStat>;
+
+class CompressionStatistics {
+ public:
+  // The returned counters live as long as the process, so callers may keep
+  // them and skip the lookup on the hot path.
+  ChannelCompressionStatPtr GetChannelStat(uint64_t channel_id);
+  bool GetStat(uint64_t channel_id, CompressionStat* stat);
+  std::string DebugString();
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<uint64_t, ChannelCompressionStatPtr> stats_;
+
+  DECLARE_SINGLETON(CompressionStatistics)
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_RTPS_PAYLOAD_COMPRESSOR_H_
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/rtps/payload_compressor.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+using cyber::proto::COMPRESSION_LZ4;
+using cyber::proto::COMPRESSION_NONE;
+using cyber::proto::COMPRESSION_ZSTD;
+
+TEST(PayloadCompressorTest, compression_flag) {
+  int32_t seq_high = 0x00123456;
+  int32_t flagged = SetCompressionFlag(seq_high, COMPRESSION_ZSTD);
+  EXPECT_EQ(COMPRESSION_ZSTD, GetCompressionFlag(flagged));
+  EXPECT_EQ(seq_high, ClearCompressionFlag(flagged));
+
+  flagged = SetCompressionFlag(seq_high, COMPRESSION_NONE);
+  EXPECT_EQ(seq_high, flagged);
+  EXPECT_EQ(COMPRESSION_NONE, GetCompressionFlag(flagged));
+}
+
+TEST(PayloadCompressorTest, round_trip) {
+  std::string raw;
+  for (int i = 0; i < 10000; ++i) {
+    raw += "cyber payload " + std::to_string(i % 100);
+  }
+
+  for (auto policy : {COMPRESSION_LZ4, COMPRESSION_ZSTD}) {
+    std::string compressed;
+    std::string decompressed;
+    EXPECT_TRUE(PayloadCompressor::Compress(policy, 1, raw, &compressed));
+    EXPECT_LT(compressed.size(), raw.size());
+    EXPECT_TRUE(
+        PayloadCompressor::Decompress(policy, compressed, &decompressed));
+    EXPECT_EQ(raw, decompressed);
+  }
+
+  std::string dst;
+  EXPECT_FALSE(PayloadCompressor::Compress(COMPRESSION_NONE, 1, raw, &dst));
+  EXPECT_FALSE(PayloadCompressor::Decompress(COMPRESSION_LZ4, "abc", &dst));
+}
+
+TEST(PayloadCompressorTest, forged_raw_size) {
+  std::string raw(1000, 'x');
+  for (auto policy : {COMPRESSION_LZ4, COMPRESSION_ZSTD}) {
+    std::string compressed;
+    ASSERT_TRUE(PayloadCompressor::Compress(policy, 1, raw, &compressed));
+
+    // sizes no frame of this length holds are refused before allocating
+    for (uint32_t forged : {0xFFFFFFFFu, 0x80000000u, 0x40000000u, 1001u}) {
+      for (size_t i = 0; i < sizeof(forged); ++i) {
+        compressed[i] = static_cast<char>((forged >> (8 * i)) & 0xFF);
+      }
+      std::string dst;
+      EXPECT_FALSE(PayloadCompressor::Decompress(policy, compressed, &dst));
+      EXPECT_LT(dst.capacity(), 1024 * 1024);
+    }
+  }
+}
+
+TEST(PayloadCompressorTest, statistics) {
+  auto stats = CompressionStatistics::Instance();
+  auto stat = stats->GetChannelStat(12345);
+  EXPECT_EQ(stat, stats->GetChannelStat(12345));
+  stat->AddCompress(1000, 250, 10);
+  stat->AddDecompress(5);
+
+  CompressionStat result;
+  EXPECT_TRUE(stats->GetStat(12345, &result));
+  EXPECT_EQ(1, result.compressed_samples);
+  EXPECT_EQ(1, result.decompressed_samples);
+  EXPECT_DOUBLE_EQ(4.0, result.Ratio());
+  EXPECT_FALSE(stats->GetStat(54321, &result));
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
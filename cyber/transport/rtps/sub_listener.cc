@@ -16,6 +16,8 @@
 
 #include "cyber/transport/rtps/sub_listener.h"
 
+#include <chrono>
+
 #include "cyber/common/log.h"
 #include "cyber/common/util.h"
 
@@ -52,14 +54,33 @@ void SubListener::onNewDataMessage(eprosima::fastrtps::Subscriber* sub) {
   spare_id.set_data(ptr + ID_SIZE);
   msg_info_.set_spare_id(spare_id);
 
+  int32_t seq_high = m_info.related_sample_identity.sequence_number().high;
+  auto codec = GetCompressionFlag(seq_high);
   uint64_t seq_num =
-      ((int64_t)m_info.related_sample_identity.sequence_number().high) << 32 |
+      ((int64_t)ClearCompressionFlag(seq_high)) << 32 |
       m_info.related_sample_identity.sequence_number().low;
   msg_info_.set_seq_num(seq_num);
 
   // fetch message string
-  std::shared_ptr<std::string> msg_str =
-      std::make_shared<std::string>(m.data());
+  std::shared_ptr<std::string> msg_str = std::make_shared<std::string>();
+  if (codec == QosCompressionPolicy::COMPRESSION_NONE) {
+    msg_str->swap(m.data());
+  } else {
+    auto start = std::chrono::steady_clock::now();
+    if (!PayloadCompressor::Decompress(codec, m.data(), msg_str.get())) {
+      AERROR << "decompress failed, channel: "
+             << sub->getAttributes().topic.getTopicName();
+      return;
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (compression_stat_ == nullptr) {
+      compression_stat_ =
+          CompressionStatistics::Instance()->GetChannelStat(channel_id);
+    }
+    compression_stat_->AddDecompress(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+            .count());
+  }
 
   // callback
   callback_(channel_id, msg_str, msg_info_);
@@ -24,6 +24,7 @@
 #include <string>
 
 #include "cyber/transport/message/message_info.h"
+#include "cyber/transport/rtps/payload_compressor.h"
 #include "cyber/transport/rtps/underlay_message.h"
 #include "cyber/transport/rtps/underlay_message_type.h"
 #include "fastrtps/Domain.h"
@@ -55,6 +56,7 @@ class SubListener : public eprosima::fastrtps::SubscriberListener {
   NewMsgCallback callback_;
   MessageInfo msg_info_;
   std::mutex mutex_;
+  ChannelCompressionStatPtr compression_stat_ = nullptr;
 };
 
 }  // namespace transport
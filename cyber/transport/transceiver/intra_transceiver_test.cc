@@ -21,6 +21,8 @@
 #include <string>
 #include <vector>
 
+#include "cyber/common/util.h"
+#include "cyber/data/data_visitor.h"
 #include "cyber/proto/unit_test.pb.h"
 #include "cyber/transport/receiver/intra_receiver.h"
 
@@ -136,6 +138,34 @@ TEST_F(IntraTranceiverTest, enable_and_disable) {
   EXPECT_EQ(msgs.size(), 0);
 }
 
+TEST_F(IntraTranceiverTest, local_reader) {
+  RoleAttributes attr;
+  attr.set_channel_name("intra_local_reader");
+  attr.set_channel_id(common::Hash(attr.channel_name()));
+  TransmitterPtr transmitter =
+      std::make_shared<IntraTransmitter<proto::UnitTest>>(attr);
+  data::DataVisitor<proto::UnitTest> visitor(attr.channel_id(), 10);
+  int notified = 0;
+  visitor.RegisterNotifyCallback([&notified]() { ++notified; });
+
+  auto msg = std::make_shared<proto::UnitTest>();
+  msg->set_case_name("local_reader");
+  // not enabled, nothing written
+  EXPECT_FALSE(transmitter->Transmit(msg));
+  transmitter->Enable();
+  EXPECT_TRUE(transmitter->Transmit(msg));
+  EXPECT_EQ(1, notified);
+
+  std::shared_ptr<proto::UnitTest> fetched;
+  EXPECT_TRUE(visitor.TryFetch(fetched));
+  EXPECT_EQ(msg, fetched);
+  EXPECT_FALSE(visitor.TryFetch(fetched));
+
+  transmitter->Disable();
+  EXPECT_FALSE(transmitter->Transmit(msg));
+  EXPECT_EQ(1, notified);
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
@@ -21,6 +21,7 @@
 #include <string>
 
 #include "cyber/common/log.h"
+#include "cyber/data/intra_writer.h"
 #include "cyber/transport/dispatcher/intra_dispatcher.h"
 #include "cyber/transport/transmitter/transmitter.h"
 
@@ -28,6 +29,9 @@ namespace apollo {
 namespace cyber {
 namespace transport {
 
+// Writes into the buffers of the readers in this process through an
+// IntraWriter, then hands the message to the listeners of the
+// IntraDispatcher. Those must not dispatch it into the reader buffers again.
 template <typename M>
 class IntraTransmitter : public Transmitter<M> {
  public:
@@ -44,6 +48,7 @@ class IntraTransmitter : public Transmitter<M> {
  private:
   uint64_t channel_id_;
   IntraDispatcherPtr dispatcher_;
+  std::unique_ptr<data::IntraWriter<M>> writer_;
 };
 
 template <typename M>
@@ -61,6 +66,7 @@ template <typename M>
 void IntraTransmitter<M>::Enable() {
   if (!this->enabled_) {
     dispatcher_ = IntraDispatcher::Instance();
+    writer_.reset(new data::IntraWriter<M>(channel_id_));
     this->enabled_ = true;
   }
 }
@@ -69,6 +75,7 @@ template <typename M>
 void IntraTransmitter<M>::Disable() {
   if (this->enabled_) {
     dispatcher_ = nullptr;
+    writer_.reset();
     this->enabled_ = false;
   }
 }
@@ -81,6 +88,7 @@ bool IntraTransmitter<M>::Transmit(const MessagePtr& msg,
     return false;
   }
 
+  writer_->Write(msg);
   dispatcher_->OnMessage(channel_id_, msg, msg_info);
   return true;
 }
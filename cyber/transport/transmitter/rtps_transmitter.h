@@ -17,6 +17,7 @@
 #ifndef CYBER_TRANSPORT_TRANSMITTER_RTPS_TRANSMITTER_H_
 #define CYBER_TRANSPORT_TRANSMITTER_RTPS_TRANSMITTER_H_
 
+#include <chrono>
 #include <memory>
 #include <string>
 
@@ -24,6 +25,7 @@
 #include "cyber/message/message_traits.h"
 #include "cyber/transport/rtps/attributes_filler.h"
 #include "cyber/transport/rtps/participant.h"
+#include "cyber/transport/rtps/payload_compressor.h"
 #include "cyber/transport/transmitter/transmitter.h"
 #include "fastrtps/Domain.h"
 #include "fastrtps/attributes/PublisherAttributes.h"
@@ -50,15 +52,32 @@ class RtpsTransmitter : public Transmitter<M> {
 
  private:
   bool Transmit(const M& msg, const MessageInfo& msg_info);
+  QosCompressionPolicy Compress(std::string* data);
 
   ParticipantPtr participant_;
   eprosima::fastrtps::Publisher* publisher_;
+
+  QosCompressionPolicy compression_;
+  uint32_t compression_threshold_;
+  int32_t compression_level_;
+  ChannelCompressionStatPtr compression_stat_;
 };
 
 template <typename M>
 RtpsTransmitter<M>::RtpsTransmitter(const RoleAttributes& attr,
                                     const ParticipantPtr& participant)
-    : Transmitter<M>(attr), participant_(participant), publisher_(nullptr) {}
+    : Transmitter<M>(attr),
+      participant_(participant),
+      publisher_(nullptr),
+      compression_(attr.qos_profile().compression()),
+      compression_threshold_(attr.qos_profile().compression_threshold()),
+      compression_level_(attr.qos_profile().compression_level()),
+      compression_stat_(nullptr) {
+  if (compression_ != QosCompressionPolicy::COMPRESSION_NONE) {
+    compression_stat_ =
+        CompressionStatistics::Instance()->GetChannelStat(attr.channel_id());
+  }
+}
 
 template <typename M>
 RtpsTransmitter<M>::~RtpsTransmitter() {
@@ -106,6 +125,8 @@ bool RtpsTransmitter<M>::Transmit(const M& msg, const MessageInfo& msg_info) {
   UnderlayMessage m;
   RETURN_VAL_IF(!message::SerializeToString(msg, &m.data()), false);
 
+  auto codec = Compress(&m.data());
+
   eprosima::fastrtps::rtps::WriteParams wparams;
 
   char* ptr =
@@ -115,7 +136,8 @@ bool RtpsTransmitter<M>::Transmit(const M& msg, const MessageInfo& msg_info) {
   memcpy(ptr + ID_SIZE, msg_info.spare_id().data(), ID_SIZE);
 
   wparams.related_sample_identity().sequence_number().high =
-      (int32_t)((msg_info.seq_num() & 0xFFFFFFFF00000000) >> 32);
+      SetCompressionFlag(
+          (int32_t)((msg_info.seq_num() & 0xFFFFFFFF00000000) >> 32), codec);
   wparams.related_sample_identity().sequence_number().low =
       (int32_t)(msg_info.seq_num() & 0xFFFFFFFF);
 
@@ -125,6 +147,36 @@ bool RtpsTransmitter<M>::Transmit(const M& msg, const MessageInfo& msg_info) {
   return publisher_->write(reinterpret_cast<void*>(&m), wparams);
 }
 
+template <typename M>
+QosCompressionPolicy RtpsTransmitter<M>::Compress(std::string* data) {
+  if (compression_ == QosCompressionPolicy::COMPRESSION_NONE ||
+      data->size() < compression_threshold_) {
+    return QosCompressionPolicy::COMPRESSION_NONE;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::string compressed;
+  if (!PayloadCompressor::Compress(compression_, compression_level_, *data,
+                                   &compressed)) {
+    AWARN_EVERY(100) << "compress failed, channel: "
+                     << this->attr_.channel_name();
+    return QosCompressionPolicy::COMPRESSION_NONE;
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  // incompressible payloads (e.g. already encoded images) go out raw
+  if (compressed.size() >= data->size()) {
+    return QosCompressionPolicy::COMPRESSION_NONE;
+  }
+
+  compression_stat_->AddCompress(
+      data->size(), compressed.size(),
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+          .count());
+  data->swap(compressed);
+  return compression_;
+}
+
 }  // namespace transport
 }  // namespace cyber
 }  // namespace apollo
@@ -60,7 +60,8 @@ class Transport {
   template <typename M>
   auto CreateReceiver(const RoleAttributes& attr,
                       const typename Receiver<M>::MessageListener& msg_listener,
-                      const OptionalMode& mode = OptionalMode::HYBRID) ->
+                      const OptionalMode& mode = OptionalMode::HYBRID,
+                      const MessageFilter& filter = nullptr) ->
       typename std::shared_ptr<Receiver<M>>;
 
   ParticipantPtr participant() const { return participant_; }
@@ -125,7 +126,8 @@ template <typename M>
 auto Transport::CreateReceiver(
     const RoleAttributes& attr,
     const typename Receiver<M>::MessageListener& msg_listener,
-    const OptionalMode& mode) -> typename std::shared_ptr<Receiver<M>> {
+    const OptionalMode& mode, const MessageFilter& filter)
+    -> typename std::shared_ptr<Receiver<M>> {
   if (is_shutdown_.load()) {
     AINFO << "transport has been shut down.";
     return nullptr;
@@ -159,6 +161,9 @@ auto Transport::CreateReceiver(
   }
 
   RETURN_VAL_IF_NULL(receiver, nullptr);
+  if (filter != nullptr) {
+    receiver->SetFilter(filter);
+  }
   if (mode != OptionalMode::HYBRID) {
     receiver->Enable();
   }
@@ -24,3 +24,17 @@ if [ $? -ne 0 ]; then
 fi
 sed -i "s#UDEV_PATH#${udev_dir}#g" WORKSPACE
 
+lz4_dir=$(pkg-config --variable=libdir liblz4 2>/dev/null)
+if [ $? -ne 0 ]; then
+    echo "===== Oops! No liblz4 found by pkg-config. ====="
+    exit 1
+fi
+sed -i "s#LZ4_PATH#${lz4_dir}#g" WORKSPACE
+
+zstd_dir=$(pkg-config --variable=libdir libzstd 2>/dev/null)
+if [ $? -ne 0 ]; then
+    echo "===== Oops! No libzstd found by pkg-config. ====="
+    exit 1
+fi
+sed -i "s#ZSTD_PATH#${zstd_dir}#g" WORKSPACE
+
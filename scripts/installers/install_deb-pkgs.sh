@@ -1,2 +1,2 @@
 sudo apt update
-sudo apt install libasio-dev libpoco-dev
+sudo apt install libasio-dev libpoco-dev liblz4-dev libzstd-dev